@@ -20,11 +20,14 @@
 #define ANTARES_DATA_PLUGIN_HPP_
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <sfz/sfz.hpp>
 #include <vector>
 
 #include "data/handle.hpp"
 #include "data/info.hpp"
+#include "lang/defines.hpp"
 #include "video/driver.hpp"
 
 namespace zipxx {
@@ -37,23 +40,39 @@ class BaseObject;
 union Level;
 struct Race;
 
+// Parsed scenario data, which does not change while games are played. It may be shared by the
+// ScenarioGlobals of several threads: objects and races are parsed on first use by any of them,
+// under `mutex`, and are never removed, so pointers into the maps remain valid.
+struct ScenarioData {
+    Info                        info;
+    std::map<int, pn::string>   chapters;
+    std::map<pn::string, Level> levels;
+
+    std::mutex                       mutex;  // Guards `objects` and `races`.
+    std::map<pn::string, BaseObject> objects;
+    std::map<pn::string, Race>       races;
+};
+
 struct ScenarioGlobals {
     sfz::optional<pn::string>          dir;
     std::unique_ptr<zipxx::ZipArchive> zip;
 
-    Info                             info;
-    std::map<int, pn::string>        chapters;
-    std::map<pn::string, Level>      levels;
-    std::map<pn::string, BaseObject> objects;
-    std::map<pn::string, Race>       races;
+    std::shared_ptr<ScenarioData> data;
+
+    // Objects and races loaded for the current level.
+    std::map<pn::string, BaseObject*> objects;
+    std::map<pn::string, Race*>       races;
 
     Texture splash;
     Texture starmap;
 };
 
-extern ScenarioGlobals plug;
+extern ANTARES_GLOBAL ScenarioGlobals plug;
 
-void PluginInit(sfz::optional<pn::string_view> path);
+// Loads the plugin at `path` (or the factory scenario). If `data` is given, it must have been
+// loaded from the same plugin; its levels are used as-is instead of being read again.
+void PluginInit(
+        sfz::optional<pn::string_view> path, std::shared_ptr<ScenarioData> data = nullptr);
 
 void load_race(const NamedHandle<const Race>& r);
 void load_object(const NamedHandle<const BaseObject>& o);
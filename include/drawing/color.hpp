@@ -93,6 +93,10 @@ uint8_t GetTranslateColorShade(Hue hue, uint8_t shade);
 RgbColor GetRGBTranslateColorShade(Hue hue, uint8_t shade);
 RgbColor GetRGBTranslateColor(uint8_t color);
 
+// The game's colors are Apple RGB (gamma 1.8); converts `color` to sRGB for display. Alpha is
+// unchanged.
+RgbColor apple_rgb_to_srgb(const RgbColor& color);
+
 }  // namespace antares
 
 #endif  // ANTARES_DRAWING_COLOR_HPP_
@@ -30,6 +30,22 @@ namespace antares {
 
 class RgbColor;
 
+// How `PixMap::encode()` compresses. A lower zlib level and a single filter are faster to encode,
+// at the cost of larger files; the defaults are libpng's.
+struct PngOptions {
+    enum class Filter {
+        DEFAULT,  // chosen per row
+        NONE,
+        SUB,
+        UP,
+        AVERAGE,
+        PAETH,
+    };
+
+    int    level  = -1;  // 0-9, or -1 for zlib's default
+    Filter filter = Filter::DEFAULT;
+};
+
 // A representation of pixel data.
 //
 // Defines an interface for objects which store pixel data, as well as some utility methods for
@@ -139,7 +155,8 @@ class PixMap {
     // Encodes this object to a file in PNG format.
     //
     // @param [in] out      the file to write to
-    void encode(pn::output_view out);
+    // @param [in] options  how to compress it
+    void encode(pn::output_view out, const PngOptions& options = PngOptions());
 };
 
 // PixMap subclass which provides its own storage.
@@ -196,6 +213,17 @@ class ArrayPixMap : public PixMap {
 // Deserializes an ArrayPixMap from its serialized PNG form.
 ArrayPixMap read_png(pn::input_view in);
 
+// Blends shades of `hue` over `pix` as directed by `overlay`, which must be the same size: the red
+// channel of each overlay pixel picks a shade, as by RgbColor::tint(), and its alpha how much of
+// the shade to blend in. The alpha of `pix` is unchanged.
+//
+// @throws std::runtime_error if `pix->size()` and `overlay.size()` are not equal.
+void tint_overlay(PixMap* pix, const PixMap& overlay, Hue hue);
+
+// Converts the pixels of `pix` from Apple RGB to sRGB in place, as by apple_rgb_to_srgb().
+// Transparent pixels are skipped, since nothing draws their color.
+void apple_rgb_to_srgb(PixMap* pix);
+
 inline void swap(ArrayPixMap& x, ArrayPixMap& y) { x.swap(y); }
 
 // A clipped view of another PixMap.
@@ -19,6 +19,7 @@
 #ifndef ANTARES_DRAWING_PIX_TABLE_HPP_
 #define ANTARES_DRAWING_PIX_TABLE_HPP_
 
+#include <memory>
 #include <vector>
 
 #include "drawing/pix-map.hpp"
@@ -29,8 +30,13 @@ namespace antares {
 class NatePixTable {
   public:
     class Frame;
+    struct Sheet;
+
+    // Loads the frames of sprite `name`, to be shared between tables of different hues.
+    static std::shared_ptr<Sheet> load(pn::string_view name);
 
     NatePixTable(pn::string_view name, Hue hue);
+    NatePixTable(std::shared_ptr<Sheet> sheet, Hue hue);
     NatePixTable(const NatePixTable&) = delete;
     NatePixTable(NatePixTable&&)      = default;
     NatePixTable& operator=(const NatePixTable&) = delete;
@@ -41,15 +47,49 @@ class NatePixTable {
     size_t       size() const;
 
   private:
-    size_t             _size;
-    std::vector<Frame> _frames;
+    std::shared_ptr<Sheet> _sheet;
+    std::vector<Frame>     _frames;
+};
+
+// The frames of a sprite, packed into atlas pages. Each page holds the untinted frames, and an
+// overlay at the same positions, which tints them by hue when drawn (see VideoDriver::atlas()).
+//
+// Pages, or regions of them, are cut from the sprite's decoded images, which are kept only while
+// they may be needed again soon: once every page that has been drawn is resident in its driver,
+// they are released, and decoded again if a page is later loaded again.
+struct NatePixTable::Sheet {
+    struct Page {
+        Size         size;
+        TextureAtlas atlas;     // created when the first of its frames is drawn
+        mutable bool resident;  // whether the whole page has been loaded
+    };
+    struct Frame {
+        Rect bounds;  // relative to the frame's center
+        Rect source;  // within the sprite's image and overlay
+        int  page;
+        Rect region;  // within its page
+    };
+
+    pn::string         name;
+    std::vector<Page>  pages;
+    std::vector<Frame> frames;
+
+    mutable std::unique_ptr<ArrayPixMap> image;    // null unless decoded
+    mutable std::unique_ptr<ArrayPixMap> overlay;  // null unless decoded
+
+    // Decodes the sprite's image and overlay, unless already done.
+    void decode() const;
+
+    // Fills `image` and `overlay`, which have the size of `region`, from that region of page
+    // `page`. Loading a whole page marks it resident, and may release the decoded images.
+    void load_page(int page, const Rect& region, PixMap* image, PixMap* overlay) const;
+
+    int64_t bytes() const;  // of its decoded images, while decoded
 };
 
 class NatePixTable::Frame {
   public:
-    Frame(Rect bounds, const PixMap& image, pn::string_view name, int frame);
-    Frame(Rect bounds, const PixMap& image, pn::string_view name, int frame, const PixMap& overlay,
-          Hue hue);
+    Frame(Sheet& sheet, int index, Hue hue);
     Frame(Frame&&) = default;
     ~Frame();
 
@@ -57,17 +97,16 @@ class NatePixTable::Frame {
     uint16_t       height() const;
     Size           size() const { return Size{width(), height()}; };
     Point          center() const;
-    const PixMap&  pix_map() const;
+    ArrayPixMap    pix_map() const;  // tinted like texture()
     const Texture& texture() const;
 
   private:
-    void load_image(const PixMap& pix);
-    void load_overlay(const PixMap& pix, Hue hue);
-    void build(pn::string_view name, int frame);
+    const Sheet::Frame& entry() const { return _sheet->frames[_index]; }
 
-    Rect        _bounds;
-    ArrayPixMap _pix_map;
-    Texture     _texture;
+    Sheet*          _sheet;
+    int             _index;
+    Hue             _hue;
+    mutable Texture _texture;  // a region of one of the sheet's atlas pages, once drawn
 };
 
 }  // namespace antares
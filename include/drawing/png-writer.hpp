@@ -0,0 +1,81 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_DRAWING_PNG_WRITER_HPP_
+#define ANTARES_DRAWING_PNG_WRITER_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <pn/string>
+#include <thread>
+#include <vector>
+
+#include "drawing/pix-map.hpp"
+
+namespace antares {
+
+// Encodes images as PNG files on a pool of worker threads, so that whoever produces them doesn't
+// wait on compression.
+//
+// Files are written in the order they were queued: workers encode concurrently, into memory, but
+// each writes its file only after every earlier one has been written. At most `capacity` images
+// may be queued or in progress at once; write() blocks until there is room, so memory use stays
+// bounded when images are produced faster than they can be compressed.
+class PngWriter {
+  public:
+    PngWriter(int threads, int capacity, PngOptions options);
+    PngWriter(const PngWriter&) = delete;
+    PngWriter& operator=(const PngWriter&) = delete;
+
+    // Writes any files still queued, then stops the workers. Errors are dropped; call finish() to
+    // see them.
+    ~PngWriter();
+
+    // Queues `pix` to be written to `path`, creating its directory if needed. Throws if an
+    // earlier file couldn't be written.
+    void write(pn::string_view path, ArrayPixMap pix);
+
+    // Waits until every queued file has been written. Throws if any couldn't be.
+    void finish();
+
+  private:
+    struct Job {
+        int64_t     sequence;
+        pn::string  path;
+        ArrayPixMap pix;
+    };
+
+    void work();
+    void check();  // rethrows `_error`; requires `_mutex`
+
+    const PngOptions         _options;
+    const int                _capacity;
+    std::mutex               _mutex;
+    std::condition_variable  _changed;  // notified whenever any of the below change
+    std::deque<Job>          _queue;
+    int64_t                  _queued   = 0;  // ever
+    int64_t                  _written  = 0;  // or failed
+    bool                     _stopping = false;
+    std::exception_ptr       _error;  // the first failure
+    std::vector<std::thread> _threads;
+};
+
+}  // namespace antares
+
+#endif  // ANTARES_DRAWING_PNG_WRITER_HPP_
@@ -25,6 +25,7 @@
 #include "data/handle.hpp"
 #include "drawing/color.hpp"
 #include "drawing/pix-table.hpp"
+#include "lang/defines.hpp"
 #include "math/fixed.hpp"
 #include "math/scale.hpp"
 
@@ -46,8 +47,6 @@ const int32_t kNoSprite         = -1;
 
 enum spriteStyleType { spriteNormal = 0, spriteColor = 2 };
 
-typedef void (*draw_tiny_t)(const Rect& rect, const RgbColor& color);
-
 class Sprite {
   public:
     static Sprite*            get(int number);
@@ -68,8 +67,9 @@ class Sprite {
         Hue     hue;
         uint8_t shade;
     } tinyColor;
-    bool        killMe;
-    draw_tiny_t draw_tiny;
+    bool                killMe;
+    bool                draw_tiny;   // whether to draw `tiny_shape` when zoomed out.
+    IconInstance::Shape tiny_shape;
 
     BaseObject::Icon icon;
 
@@ -78,7 +78,7 @@ class Sprite {
     static const size_t size = 500;
 };
 
-extern Scale gAbsoluteScale;
+extern ANTARES_GLOBAL Scale gAbsoluteScale;
 
 class Pix {
   public:
@@ -87,7 +87,26 @@ class Pix {
     NatePixTable*       get(pn::string_view id, Hue hue);
     const NatePixTable* cursor();
 
+    int64_t sheet_count() const { return _sheets.size(); }
+    int64_t table_count() const { return _pix.size(); }
+    int64_t sheet_bytes() const;  // of their decoded images
+
   private:
+    struct CachedSheet {
+        std::shared_ptr<NatePixTable::Sheet> sheet;
+        int64_t                              last_use;
+    };
+
+    std::shared_ptr<NatePixTable::Sheet> sheet(pn::string_view name);
+    void                                 evict();
+
+    // Sheets, by plugin and sprite name, shared by all hues. They outlive reset(), along with the
+    // textures created from them, so that changing levels or admiral colors doesn't load the same
+    // sprites again. Those not in use are evicted, least recently used first, while the total
+    // exceeds a budget.
+    std::map<std::pair<pn::string, pn::string>, CachedSheet> _sheets;
+    int64_t                                                  _uses = 0;
+
     std::map<std::pair<pn::string, Hue>, NatePixTable> _pix;
     std::unique_ptr<NatePixTable>                      _cursor;
 };
@@ -100,6 +119,7 @@ Handle<Sprite> AddSprite(
         Scale scale, sfz::optional<BaseObject::Icon> icon, BaseObject::Layer layer, Hue tiny_hue,
         uint8_t tiny_shade);
 void RemoveSprite(Handle<Sprite> sprite);
+void SetSpriteLayer(Handle<Sprite> sprite, BaseObject::Layer layer);
 void draw_sprites();
 void CullSprites();
 
@@ -0,0 +1,54 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_DRAWING_Y4M_WRITER_HPP_
+#define ANTARES_DRAWING_Y4M_WRITER_HPP_
+
+#include <pn/output>
+#include <vector>
+
+#include "drawing/pix-map.hpp"
+
+namespace antares {
+
+// Writes images as the frames of an uncompressed YUV4MPEG2 stream, which ffmpeg and most other
+// encoders read directly.
+//
+// Frames are converted to 4:2:0 Y'CbCr with BT.601 coefficients at limited range, which is what
+// readers assume of a stream without colorspace tags. Chroma is averaged over each 2x2 block. The
+// stream header is written with the first frame, whose size every later frame must share.
+class Y4mWriter {
+  public:
+    // Frames are shown at `rate_num / rate_den` frames per second.
+    Y4mWriter(pn::output_view out, int rate_num, int rate_den);
+    Y4mWriter(const Y4mWriter&) = delete;
+    Y4mWriter& operator=(const Y4mWriter&) = delete;
+
+    void write(const PixMap& pix);
+
+  private:
+    pn::output_view      _out;
+    const int            _rate_num;
+    const int            _rate_den;
+    int64_t              _frames = 0;
+    Size                 _size   = {0, 0};
+    std::vector<uint8_t> _planes;  // Y, then Cb, then Cr, for one frame
+};
+
+}  // namespace antares
+
+#endif  // ANTARES_DRAWING_Y4M_WRITER_HPP_
@@ -20,6 +20,7 @@
 #define ANTARES_GAME_ACTION_HPP_
 
 #include <memory>
+#include <vector>
 
 #include "data/base-object.hpp"
 
@@ -47,6 +48,21 @@ struct ActionQueue {
 void reset_action_queue();
 void execute_action_queue();
 
+// One pending entry of the action queue, as seen from outside it.
+struct QueuedActions {
+    ticks               scheduled_time;  // Time remaining until execution.
+    const Action*       begin;
+    const Action*       end;
+    Handle<SpaceObject> subject;
+    int32_t             subject_id;
+    Handle<SpaceObject> direct;
+    int32_t             direct_id;
+    Point               offset;
+};
+
+// Returns the pending entries of the action queue, in the order they will execute.
+std::vector<QueuedActions> queued_actions();
+
 }  // namespace antares
 
 #endif  // ANTARES_GAME_ACTION_HPP_
@@ -21,6 +21,7 @@
 
 #include "drawing/color.hpp"
 #include "drawing/pix-table.hpp"
+#include "lang/defines.hpp"
 #include "math/geometry.hpp"
 #include "math/units.hpp"
 #include "ui/event.hpp"
@@ -68,11 +69,11 @@ class HintLine {
     static void draw();
 
   private:
-    static bool     show_hint_line;
-    static Point    hint_line_start;
-    static Point    hint_line_end;
-    static RgbColor hint_line_color;
-    static RgbColor hint_line_color_dark;
+    static ANTARES_GLOBAL bool     show_hint_line;
+    static ANTARES_GLOBAL Point    hint_line_start;
+    static ANTARES_GLOBAL Point    hint_line_end;
+    static ANTARES_GLOBAL RgbColor hint_line_color;
+    static ANTARES_GLOBAL RgbColor hint_line_color_dark;
 };
 
 }  // namespace antares
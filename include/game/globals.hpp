@@ -28,6 +28,7 @@
 #include "drawing/color.hpp"
 #include "game/action.hpp"
 #include "game/starfield.hpp"
+#include "lang/defines.hpp"
 #include "math/random.hpp"
 #include "math/units.hpp"
 #include "sound/fx.hpp"
@@ -120,9 +121,9 @@ struct GlobalState {
     Handle<SpaceObject> farthest;  // Farthest object (sufficient for zoom-to-all).
 };
 
-extern GlobalState& g;  // head
-extern GlobalState  head;
-extern GlobalState  tail;
+extern ANTARES_GLOBAL GlobalState& g;  // head
+extern ANTARES_GLOBAL GlobalState  head;
+extern ANTARES_GLOBAL GlobalState  tail;
 
 struct aresGlobalType {
     aresGlobalType();
@@ -19,7 +19,10 @@
 #ifndef ANTARES_GAME_MAIN_HPP_
 #define ANTARES_GAME_MAIN_HPP_
 
+#include <functional>
+
 #include "data/replay.hpp"
+#include "math/units.hpp"
 #include "ui/card.hpp"
 #include "ui/interface-handling.hpp"
 
@@ -36,6 +39,11 @@ enum GameResult {
     QUIT_GAME    = 3,
 };
 
+// Advances the world by `units`, which must not cross a major tick. On a major tick, `input` is
+// called once ships and admirals have thought and queued actions have run; it should apply any
+// player input before collisions and level conditions are checked.
+void advance_world(ticks units, const std::function<void()>& input);
+
 class MainPlay : public Card {
   public:
     MainPlay(
@@ -0,0 +1,35 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_GAME_MEMORY_REPORT_HPP_
+#define ANTARES_GAME_MEMORY_REPORT_HPP_
+
+#include <pn/output>
+
+namespace antares {
+
+// Writes the memory held by each subsystem to `out`, one `path\tvalue` line per figure, as by
+// dump_state(): sprites, fonts, sounds, scenario data, and the fixed object pools.
+//
+// Byte counts are of the large buffers each subsystem owns, wherever they live (sprite pages and
+// fonts are counted at their size on the GPU). Scenario data is counted shallowly, without the
+// strings and vectors that its records own, so it is an underestimate.
+void report_memory(pn::output_view out);
+
+}  // namespace antares
+
+#endif  // ANTARES_GAME_MEMORY_REPORT_HPP_
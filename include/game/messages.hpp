@@ -26,6 +26,7 @@
 #include "drawing/color.hpp"
 #include "drawing/styled-text.hpp"
 #include "game/globals.hpp"
+#include "lang/defines.hpp"
 #include "math/geometry.hpp"
 
 namespace antares {
@@ -59,9 +60,9 @@ class Messages {
 
     static void set_status(pn::string_view status, Hue hue);
 
-    static std::queue<pn::string> message_data;
-    static longMessageType*       long_message_data;
-    static ticks                  time_count;
+    static ANTARES_GLOBAL std::queue<pn::string> message_data;
+    static ANTARES_GLOBAL longMessageType*       long_message_data;
+    static ANTARES_GLOBAL ticks                  time_count;
 };
 
 }  // namespace antares
@@ -20,6 +20,7 @@
 #define ANTARES_GAME_MOTION_HPP_
 
 #include "data/base-object.hpp"
+#include "lang/defines.hpp"
 #include "math/scale.hpp"
 #include "math/units.hpp"
 
@@ -29,8 +30,8 @@ struct ScaledScreen {
     Scale scale;
     Rect  bounds;
 };
-extern ScaledScreen scaled_screen;
-Point               scale_to_viewport(Point p);
+extern ANTARES_GLOBAL ScaledScreen scaled_screen;
+Point                              scale_to_viewport(Point p);
 
 void ResetMotionGlobals();
 
@@ -0,0 +1,35 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_GAME_STATE_DUMP_HPP_
+#define ANTARES_GAME_STATE_DUMP_HPP_
+
+#include <pn/output>
+
+namespace antares {
+
+// Writes the complete simulation state to `out`, one `path\tvalue` line per field.
+//
+// The order of lines is fixed: global state, then admirals, destinations, space objects and
+// vectors by slot, then the action queue in the order it will execute. Unused slots are skipped.
+// Each space object starts with its `id` and `base` lines, so that a differing field can be
+// mapped back to the object it belongs to (see scripts/state-diff).
+void dump_state(pn::output_view out);
+
+}  // namespace antares
+
+#endif  // ANTARES_GAME_STATE_DUMP_HPP_
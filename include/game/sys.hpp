@@ -19,11 +19,13 @@
 #ifndef ANTARES_GAME_SYS_HPP_
 #define ANTARES_GAME_SYS_HPP_
 
+#include <memory>
 #include <pn/string>
 #include <vector>
 
 #include "drawing/sprite-handling.hpp"
 #include "drawing/text.hpp"
+#include "lang/defines.hpp"
 #include "sound/fx.hpp"
 #include "sound/music.hpp"
 
@@ -48,8 +50,9 @@ struct SystemGlobals {
     std::vector<pn::string> gamepad_names;
     std::vector<pn::string> gamepad_long_names;
 
+    // Loaded once per process, and shared read-only by the game state of every thread.
     enum { ROT_TABLE_SIZE = 720 };
-    std::vector<int32_t> rot_table;
+    std::shared_ptr<const std::vector<int32_t>> rot_table;
 
     SoundDriver* audio = nullptr;
     VideoDriver* video = nullptr;
@@ -74,7 +77,7 @@ struct SystemGlobals {
     Texture right_instrument_texture;
 };
 
-extern SystemGlobals sys;
+extern ANTARES_GLOBAL SystemGlobals sys;
 
 void sys_init();
 void sys_shutdown();
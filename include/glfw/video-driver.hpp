@@ -35,6 +35,18 @@ class Event;
 
 class GLFWVideoDriver : public OpenGlVideoDriver {
   public:
+    // How closely frames kept to the display. A frame is due once something has changed, but not
+    // before a frame interval has passed since the last one; intervals are only counted between
+    // frames drawn back to back, while something changed every frame.
+    struct FrameStats {
+        int64_t frames   = 0;
+        int64_t late     = 0;  // shown after the refresh they were due for
+        int64_t paced    = 0;  // frames drawn back to back
+        usecs   total    = usecs(0);  // between the `paced` frames and those before them
+        usecs   shortest = usecs::max();
+        usecs   longest  = usecs(0);
+    };
+
     GLFWVideoDriver();
     virtual ~GLFWVideoDriver();
 
@@ -55,7 +67,12 @@ class GLFWVideoDriver : public OpenGlVideoDriver {
 
     void loop(Card* initial);
 
+    const FrameStats& frame_stats() const { return _frame_stats; }
+
   private:
+    void        redraw();
+    void        wait(wall_time next_frame);
+    void        swap(wall_time next_frame);
     void        key(int key, int scancode, int action, int mods);
     void        char_(unsigned int code_point);
     void        edit(int key, int action, int mods);
@@ -69,6 +86,7 @@ class GLFWVideoDriver : public OpenGlVideoDriver {
     static void mouse_move_callback(GLFWwindow* w, double x, double y);
     static void window_size_callback(GLFWwindow* w, int width, int height);
     static void window_maximize_callback(GLFWwindow* w, int maximized);
+    static void window_refresh_callback(GLFWwindow* w);
 
     bool            _fullscreen;
     Size            _screen_size;
@@ -79,6 +97,12 @@ class GLFWVideoDriver : public OpenGlVideoDriver {
     wall_time       _last_click_usecs;
     int             _last_click_count;
     TextReceiver*   _text;
+
+    usecs      _frame_interval;
+    bool       _redraw;
+    wall_time  _redraw_since;  // when _redraw was set
+    wall_time  _last_shown;
+    FrameStats _frame_stats;
 };
 
 }  // namespace antares
@@ -19,6 +19,12 @@
 #ifndef ANTARES_LANG_DEFINES_HPP_
 #define ANTARES_LANG_DEFINES_HPP_
 
-#define ANTARES_GLOBAL
+// Marks mutable state that belongs to a running game (and the systems it draws on), as opposed
+// to process-wide configuration. Such state is bound per thread, so that each thread can load a
+// level and run its own game independently of games on other threads.
+//
+// Declarations in headers carry the marker too, so that every translation unit agrees on the
+// storage duration.
+#define ANTARES_GLOBAL thread_local
 
 #endif  // ANTARES_LANG_DEFINES_HPP_
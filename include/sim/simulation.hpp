@@ -0,0 +1,109 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_SIM_SIMULATION_HPP_
+#define ANTARES_SIM_SIMULATION_HPP_
+
+#include <memory>
+#include <sfz/sfz.hpp>
+
+#include "data/handle.hpp"
+#include "game/admiral.hpp"
+#include "game/space-object.hpp"
+#include "game/vector.hpp"
+#include "math/units.hpp"
+
+namespace antares {
+
+struct ScenarioData;
+
+// A read-only view of one of the simulation's slot arrays. Slots are indexed like their
+// handles (`Handle<T>::number()`), and include unused ones; check `active` before reading.
+template <typename T>
+class SlotView {
+  public:
+    SlotView(const T* data, size_t size) : _data(data), _size(size) {}
+
+    const T* begin() const { return _data; }
+    const T* end() const { return _data + _size; }
+    size_t   size() const { return _size; }
+
+    const T& operator[](size_t i) const { return _data[i]; }
+    const T& operator[](Handle<T> h) const { return _data[h.number()]; }
+
+  private:
+    const T* _data;
+    size_t   _size;
+};
+
+// A snapshot of the simulation, by reference. The views point directly into the game state, so
+// they change as the simulation steps, and are invalidated by load_level().
+struct SimulationState {
+    game_ticks      time;
+    bool            game_over;
+    Handle<Admiral> victor;
+
+    SlotView<Admiral>     admirals;
+    SlotView<Destination> destinations;
+    SlotView<SpaceObject> objects;
+    SlotView<Vector>      vectors;
+};
+
+// Runs levels without a Card stack, event loop, or rendering backend, as fast as the caller
+// steps them.
+//
+// The game state is bound to the calling thread (see ANTARES_GLOBAL), so there may be at most one
+// Simulation per thread, and it must only be used from the thread that created it. Independent
+// matches can run on separate threads, sharing parsed scenario data through `scenario`.
+class Simulation {
+  public:
+    // Loads the factory scenario, or uses `scenario` if given.
+    explicit Simulation(std::shared_ptr<ScenarioData> scenario = nullptr);
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+    ~Simulation();
+
+    // Sets up the level `name` (its path under levels/, without extension) from scratch, seeding
+    // the game's random number generator with `seed`. Throws if there is no such level.
+    void load_level(pn::string_view name, int32_t seed);
+
+    // Advances the simulation by up to `n` ticks, stopping early once the game is over. Returns
+    // the number of ticks simulated.
+    ticks step(ticks n);
+
+    // Holds down `keys` (kUpKey, kPulseKey, etc.) on the flagship of `admiral`, overriding its
+    // AI, until changed by another call or by release_input().
+    void apply_input(Handle<Admiral> admiral, uint32_t keys);
+    void release_input(Handle<Admiral> admiral);
+
+    SimulationState read_state() const;
+
+    // True once the level has been won or lost.
+    bool done() const;
+
+  private:
+    class Drivers;
+
+    void apply_inputs();
+
+    std::unique_ptr<Drivers> _drivers;
+    sfz::optional<uint32_t>  _keys[kMaxPlayerNum];
+};
+
+}  // namespace antares
+
+#endif  // ANTARES_SIM_SIMULATION_HPP_
@@ -35,6 +35,8 @@ class Sound {
 
     virtual void play(uint8_t volume) = 0;
     virtual void loop(uint8_t volume) = 0;
+
+    virtual int64_t bytes() const = 0;  // of samples held by the driver
 };
 
 class SoundChannel {
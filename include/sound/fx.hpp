@@ -42,6 +42,9 @@ class SoundFX {
     void reset();
     void stop();
 
+    int64_t loaded() const;  // number of sounds
+    int64_t bytes() const;   // of their samples
+
     void play(pn::string_view id, uint8_t volume, usecs persistence, uint8_t priority);
     void play_at(
             pn::string_view id, int32_t volume, usecs persistence, uint8_t priority,
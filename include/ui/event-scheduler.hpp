@@ -19,6 +19,7 @@
 #ifndef ANTARES_UI_EVENT_SCHEDULER_HPP_
 #define ANTARES_UI_EVENT_SCHEDULER_HPP_
 
+#include <sfz/sfz.hpp>
 #include <vector>
 
 #include "config/keys.hpp"
@@ -44,6 +45,10 @@ class EventScheduler {
     EventScheduler& operator=(const EventScheduler&) = delete;
 
     void schedule_snapshot(int64_t at);
+    // Schedules a snapshot every `interval` ticks from `start`, up to but not including `end`, or
+    // indefinitely. The next one is only computed once the last has been taken, so this costs the
+    // same however many there are.
+    void schedule_snapshots(int64_t start, int64_t interval, sfz::optional<int64_t> end);
     void schedule_event(std::unique_ptr<Event> event);
     void schedule_key(Key key, int64_t down, int64_t up);
     void schedule_mouse(int button, const Point& where, int64_t down, int64_t up);
@@ -56,12 +61,20 @@ class EventScheduler {
 
   private:
     void advance_tick_count(MainLoop& loop, wall_ticks ticks);
-    bool have_snapshots_before(wall_ticks ticks) const;
+    bool       have_snapshots_before(wall_ticks ticks) const;
+    wall_ticks pop_snapshot();
 
     static bool is_later(const std::unique_ptr<Event>& x, const std::unique_ptr<Event>& y);
 
+    struct SnapshotRule {
+        wall_ticks                next;
+        ticks                     interval;
+        sfz::optional<wall_ticks> end;
+    };
+
     wall_ticks                          _ticks;
     std::vector<wall_ticks>             _snapshot_times;
+    std::vector<SnapshotRule>           _snapshot_rules;
     std::vector<std::unique_ptr<Event>> _event_heap;
     Point                               _mouse;
 };
@@ -0,0 +1,112 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_VIDEO_DRAW_LOG_HPP_
+#define ANTARES_VIDEO_DRAW_LOG_HPP_
+
+#include <stdint.h>
+#include <pn/data>
+#include <pn/string>
+#include <utility>
+#include <vector>
+
+#include "drawing/color.hpp"
+
+namespace antares {
+
+// The commands logged by TextVideoDriver. The values are part of the binary format, so new
+// commands go at the end.
+enum class DrawOp : uint8_t {
+    DRAW        = 1,
+    CROP        = 2,
+    CROP_SCALED = 3,
+    TINT        = 4,
+    STATIC      = 5,
+    OUTLINE     = 6,
+    RECT        = 7,
+    DITHER      = 8,
+    POINT       = 9,
+    LINE        = 10,
+    TRIANGLE    = 11,
+    DIAMOND     = 12,
+    PLUS        = 13,
+};
+
+// A texture name, with an `id` that is unique to the name for the life of the log.
+struct DrawLogName {
+    uint32_t        id;
+    pn::string_view name;
+};
+
+// Renders draw commands as tab-separated lines, one per command. When a command repeats the one
+// before it, the command and each argument equal to the one in the same position are left empty.
+class TextDrawLog {
+  public:
+    void begin(DrawOp op);
+    void arg(int64_t i);
+    void arg(RgbColor color);
+    void arg(pn::string_view s);
+    void arg(const DrawLogName& name) { arg(name.name); }
+    void end();
+
+    void              clear();
+    const pn::string& text() const { return _log; }
+
+  private:
+    void            add(pn::string_view s);
+    pn::string_view last(size_t index) const;
+
+    pn::string                             _log;
+    std::vector<std::pair<size_t, size_t>> _args;
+    std::vector<std::pair<size_t, size_t>> _last_args;
+    bool                                   _new_command = true;
+};
+
+// Encodes draw commands compactly, for decoding to TextDrawLog's form with decode_draw_log().
+//
+// After a magic number, each command is its opcode followed by its arguments, all as varints:
+// integers are zigzag-encoded, and colors are packed with the alpha inverted, so that opaque
+// colors are short. A name is written as its id shifted left by one; the first time it appears
+// after clear(), the low bit is set, and the length and bytes of the name follow.
+class BinaryDrawLog {
+  public:
+    BinaryDrawLog();
+
+    void begin(DrawOp op) { varint(static_cast<uint8_t>(op)); }
+    void arg(int64_t i) { varint((static_cast<uint64_t>(i) << 1) ^ (i >> 63)); }
+    void arg(RgbColor color);
+    void arg(const DrawLogName& name);
+    void end() {}
+
+    void          clear();
+    pn::data_view data() const;
+
+  private:
+    void varint(uint64_t u);
+
+    std::vector<uint8_t>  _data;
+    std::vector<uint32_t> _defined;  // by id, the generation in which it was last defined.
+    uint32_t              _generation = 1;
+};
+
+// Renders a log written by BinaryDrawLog as TextDrawLog would have. Throws if `data` is not a
+// well-formed binary log.
+pn::string decode_draw_log(pn::data_view data);
+
+}  // namespace antares
+
+#endif  // ANTARES_VIDEO_DRAW_LOG_HPP_
@@ -20,8 +20,10 @@
 #define ANTARES_VIDEO_DRIVER_HPP_
 
 #include <stdint.h>
+#include <functional>
 #include <memory>
 #include <pn/string>
+#include <vector>
 
 #include "drawing/color.hpp"
 #include "math/geometry.hpp"
@@ -34,8 +36,28 @@ class Card;
 class KeyMap;
 class PixMap;
 class Texture;
+class TextureAtlas;
 class TextReceiver;
 
+// A sprite frame for VideoDriver::draw_sprites(), drawn into `rect` as by Texture::draw(), or by
+// Texture::draw_static() with `color` and `frac` if `is_static`.
+struct SpriteInstance {
+    const Texture* texture;
+    Rect           rect;
+    bool           is_static;
+    RgbColor       color;
+    uint8_t        frac;
+};
+
+// A tactical icon for VideoDriver::draw_icons(). Squares fill `rect`; other shapes are drawn in
+// the largest square at its top-left corner, as by draw_triangle(), draw_diamond() or draw_plus().
+struct IconInstance {
+    enum Shape { SQUARE, TRIANGLE, DIAMOND, PLUS };
+    Shape    shape;
+    Rect     rect;
+    RgbColor color;
+};
+
 class VideoDriver {
   public:
     VideoDriver();
@@ -59,10 +81,42 @@ class VideoDriver {
     virtual void    draw_diamond(const Rect& rect, const RgbColor& color)           = 0;
     virtual void    draw_plus(const Rect& rect, const RgbColor& color)              = 0;
 
+    // Fills in the pixels of `region` of an atlas page, and of its overlay, into `image` and
+    // `overlay`, both already of the region's size.
+    typedef std::function<void(const Rect& region, PixMap* image, PixMap* overlay)> AtlasLoader;
+
+    // Creates an atlas page of `size`, to draw textures from regions of it. Regions must be
+    // surrounded by at least one pixel of clear space, which outlined drawing relies on. Textures
+    // with a hue other than GRAY are drawn with a shade of their hue blended over them from the
+    // overlay, as by tint_overlay().
+    //
+    // `load` is called only once the pixels are needed, and may be called again if the driver
+    // released them, so that the caller needn't keep them. It must remain callable while the
+    // atlas or any of its textures exist. By default, each texture is created separately, from
+    // its region alone, loaded as the texture is created; no pixels of the page are kept.
+    virtual TextureAtlas atlas(Size size, AtlasLoader load);
+
+    // The bytes of atlas pages that the driver keeps loaded. By default, none.
+    virtual int64_t atlas_bytes() const { return 0; }
+
+    // Draws one layer of sprites. Drivers may reorder sprites to draw them in fewer batches, so
+    // the order of overlapping sprites within a layer is unspecified. By default, draws each
+    // sprite in order.
+    virtual void draw_sprites(const std::vector<SpriteInstance>& sprites);
+
+    // Draws every visible icon, in order. By default, forwards each to the per-shape methods.
+    virtual void draw_icons(const std::vector<IconInstance>& icons);
+
+  protected:
+    // The implementation of `texture`, which must have been created by this driver as a `T`.
+    template <typename T>
+    static const T& texture_impl(const Texture& texture);
+
   private:
     friend class Points;
     friend class Lines;
     friend class Rects;
+    friend class TeeVideoDriver;
 
     virtual void begin_points() {}
     virtual void end_points() {}
@@ -147,6 +201,7 @@ class Texture {
 
   private:
     friend class Quads;
+    friend class VideoDriver;
 
     Rect rect(int32_t x, int32_t y) const {
         return Rect(x, y, x + _impl->size().width, y + _impl->size().height);
@@ -155,6 +210,35 @@ class Texture {
     std::unique_ptr<Impl> _impl;
 };
 
+template <typename T>
+const T& VideoDriver::texture_impl(const Texture& texture) {
+    return static_cast<const T&>(*texture._impl);
+}
+
+class TextureAtlas {
+  public:
+    struct Impl {
+        Impl() {}
+        Impl(const Impl&) = delete;
+        Impl& operator=(const Impl&) = delete;
+        virtual ~Impl();
+
+        virtual Texture texture(pn::string_view name, const Rect& region, Hue hue) const = 0;
+    };
+
+    TextureAtlas(std::nullptr_t n = nullptr) {}
+    TextureAtlas(std::unique_ptr<Impl> impl) : _impl(std::move(impl)) {}
+
+    operator bool() const { return _impl != nullptr; }
+
+    Texture texture(pn::string_view name, const Rect& region, Hue hue = Hue::GRAY) const {
+        return _impl->texture(name, region, hue);
+    }
+
+  private:
+    std::unique_ptr<Impl> _impl;
+};
+
 class TextReceiver {
   public:
     template <typename T>
@@ -0,0 +1,70 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_VIDEO_EXPECTED_SNAPSHOTS_HPP_
+#define ANTARES_VIDEO_EXPECTED_SNAPSHOTS_HPP_
+
+#include <pn/data>
+#include <pn/string>
+#include <set>
+#include <sfz/sfz.hpp>
+
+#include "drawing/pix-map.hpp"
+
+namespace antares {
+
+// Compares snapshots, as they are taken, against the goldens in a directory, so that a run that
+// matches writes nothing.
+//
+// A mismatch throws, unless `keep_going` is set, in which case it is reported to stderr, and the
+// snapshot is written to `output_dir`, if any; for an image the same size as its golden, so is a
+// diff, beside it as NAME.diff.png. Either way, finish() throws if anything didn't match.
+//
+// Text must match exactly, except that "\r\n" in a golden matches "\n" (e.g. with core.autocrlf).
+// An image matches if no channel of any pixel differs from its golden by more than `tolerance`,
+// so that drivers which round differently can share goldens.
+class ExpectedSnapshots {
+  public:
+    ExpectedSnapshots(
+            pn::string_view dir, const sfz::optional<pn::string>& output_dir, bool keep_going,
+            int tolerance);
+    ExpectedSnapshots(const ExpectedSnapshots&) = delete;
+    ExpectedSnapshots& operator=(const ExpectedSnapshots&) = delete;
+
+    // Compares a text snapshot, or an image, with the golden at `relpath`.
+    void check(pn::string_view relpath, pn::data_view data);
+    void check(pn::string_view relpath, const PixMap& pix);
+
+    // Checks that every golden snapshot, under screens/, was taken, then throws if any snapshot
+    // didn't match.
+    void finish();
+
+  private:
+    void mismatch(pn::string_view relpath, pn::string_view reason);
+    void write(pn::string_view relpath, pn::data_view data);
+
+    const pn::string          _dir;
+    sfz::optional<pn::string> _output_dir;
+    const bool                _keep_going;
+    const int                 _tolerance;
+    std::set<pn::string>      _taken;
+    int                       _mismatches = 0;
+};
+
+}  // namespace antares
+
+#endif  // ANTARES_VIDEO_EXPECTED_SNAPSHOTS_HPP_
@@ -24,8 +24,12 @@
 #include <utility>
 
 #include "config/keys.hpp"
+#include "drawing/pix-map.hpp"
+#include "drawing/y4m-writer.hpp"
 #include "ui/event-scheduler.hpp"
+#include "video/expected-snapshots.hpp"
 #include "video/opengl-driver.hpp"
+#include "video/tee-driver.hpp"
 
 namespace antares {
 
@@ -56,13 +60,34 @@ class OffscreenVideoDriver : public OpenGlVideoDriver {
     void capture(std::vector<std::pair<std::unique_ptr<Card>, pn::string>>& pix);
     void set_capture_rect(Rect r) { _capture_rect = r; }
 
+    std::unique_ptr<TeeVideoDriver::Output> tee_output();
+
+    // Snapshots are compressed with `options`, on `threads` threads (by default, one per core).
+    void set_png_options(PngOptions options, int threads = 0) {
+        _png_options = options;
+        _png_threads = threads;
+    }
+
+    // If set, snapshots are compared with `expected` instead of being written.
+    void set_expected(ExpectedSnapshots* expected) { _expected = expected; }
+
+    // Writes snapshots to `out` as the frames of a Y4M video, at `rate_num / rate_den` frames per
+    // second, instead of as PNG files. The output directory, if any, is then only used for sound.
+    void set_video_output(pn::output_view out, int rate_num, int rate_den) {
+        _video.reset(new Y4mWriter(out, rate_num, rate_den));
+    }
+
   private:
-    const Size                _screen_size;
-    const int                 _scale;
-    const std::pair<int, int> _gl_version;
-    const pn::string          _glsl_version;
-    sfz::optional<pn::string> _output_dir;
-    Rect                      _capture_rect;
+    const Size                 _screen_size;
+    const int                  _scale;
+    const std::pair<int, int>  _gl_version;
+    const pn::string           _glsl_version;
+    sfz::optional<pn::string>  _output_dir;
+    Rect                       _capture_rect;
+    PngOptions                 _png_options;
+    int                        _png_threads = 0;
+    std::unique_ptr<Y4mWriter> _video;
+    ExpectedSnapshots*         _expected = nullptr;
 
     EventScheduler* _scheduler = nullptr;
 };
@@ -22,6 +22,8 @@
 #include <stdint.h>
 
 #include <map>
+#include <set>
+#include <vector>
 
 #include "drawing/color.hpp"
 #include "math/geometry.hpp"
@@ -32,6 +34,7 @@
 namespace antares {
 
 class Event;
+class OpenGlTexturePage;
 
 typedef int sampler2D;
 typedef int sampler2DRect;
@@ -42,10 +45,14 @@ struct vec4 {
     float x, y, z, w;
 };
 
+// A uniform of one program. set() remembers the last value, and skips the GL call when it hasn't
+// changed.
 template <typename T>
 struct Uniform {
-    const char* name;
-    int         location;
+    const char*  name;
+    int          location;
+    mutable bool cached;
+    mutable T    value;
 
     void load(int program);
     void set(T value) const;
@@ -65,20 +72,147 @@ class OpenGlVideoDriver : public VideoDriver {
     virtual void    draw_diamond(const Rect& rect, const RgbColor& color);
     virtual void    draw_plus(const Rect& rect, const RgbColor& color);
 
+    virtual TextureAtlas atlas(Size size, AtlasLoader load);
+    virtual int64_t      atlas_bytes() const { return _gl.resident_bytes; }
+    virtual void         draw_sprites(const std::vector<SpriteInstance>& sprites);
+    virtual void         draw_icons(const std::vector<IconInstance>& icons);
+
     virtual void*   get_proc_address(const char* proc_name) const;
 
     struct Uniforms {
         Uniform<vec2>          screen          = {"screen"};
         Uniform<int>           scale           = {"scale"};
-        Uniform<int>           color_mode      = {"color_mode"};
         Uniform<sampler2DRect> sprite          = {"sprite"};
         Uniform<sampler2D>     static_image    = {"static_image"};
         Uniform<float>         static_fraction = {"static_fraction"};
         Uniform<vec2>          unit            = {"unit"};
         Uniform<vec4>          outline_color   = {"outline_color"};
+        Uniform<vec4>          outline_bounds  = {"outline_bounds"};
         Uniform<int>           seed            = {"seed"};
+        Uniform<int>           tint            = {"tint"};
+        Uniform<int>           overlay_offset  = {"overlay_offset"};
+        Uniform<sampler2D>     palette         = {"palette"};
+    };
+
+    // Counts of GL calls made while drawing, for comparing rendering strategies.
+    struct Stats {
+        int64_t frames         = 0;
+        int64_t draw_calls     = 0;
+        int64_t buffer_uploads = 0;
+        int64_t texture_binds  = 0;
+        int64_t textures       = 0;  // currently allocated
+        int64_t page_uploads   = 0;  // of atlas pages
+        int64_t page_evictions = 0;
+        int64_t program_uses   = 0;  // glUseProgram() calls
     };
 
+    // GL state shared by the driver and its textures.
+    struct Context {
+        Stats stats;
+
+        // One program per color mode, each compiled from the same shader source with COLOR_MODE
+        // defined, so that the fragment shader doesn't branch on the mode at runtime. Uniform
+        // locations and values are per program; the values shared by every program are kept
+        // here, and passed on by use() when each program is next used.
+        static const int kColorModes = 6;
+        struct Program {
+            uint32_t id = 0;
+            Uniforms uniforms;
+        };
+        Program programs[kColorModes];
+        int     current_mode = -1;  // of the program in use
+        vec2    screen       = {0, 0};
+        int     scale        = 1;
+        int     seed         = 0;
+
+        // Switches to the program for `mode`, if not already in use, and returns its uniforms.
+        Uniforms& use(int mode);
+
+        // The two vertex formats, each captured in a vertex array object over `stream` with GL
+        // 3.2. Both are 12 bytes, so that they can share the stream and be addressed by vertex
+        // index.
+        struct ColorVertex {
+            float   x, y;
+            uint8_t color[4];
+        };
+        struct SpriteVertex {
+            int16_t x, y;
+            uint8_t color[4];
+            int16_t u, v;
+        };
+        uint32_t color_array   = 0;
+        uint32_t sprite_array  = 0;
+        uint32_t bound_array   = 0;
+        bool     vertex_arrays = false;  // false with GL 2.0, which has no vertex array objects
+
+        // A ring buffer that vertices are streamed through, in segments of kSegmentVertices.
+        // With GL 3.2, writes go through unsynchronized mapped ranges, and each segment is fenced
+        // when it is left and waited on before it is reused. With GL 2.0, which has neither, the
+        // buffer is orphaned each time it wraps and written with glBufferSubData().
+        static const int kSegments         = 4;
+        static const int kSegmentVertices  = 1 << 16;
+        uint32_t         stream            = 0;
+        bool             fenced            = false;
+        int              segment           = 0;
+        int              head              = 0;  // next free vertex in `stream`
+        void*            fences[kSegments] = {};
+
+        // Copies `count` vertices (at most kSegmentVertices) into the stream, returning the index
+        // of the first one.
+        int32_t upload(const void* vertices, int count);
+        void    bind(uint32_t array);
+
+        // The sprite texture bound to unit 0, which is kept active after setup.
+        uint32_t bound_texture = 0;
+        void     bind_texture(uint32_t texture);
+
+        // Atlas pages are uploaded when first drawn, at most `max_uploads` per frame (0 for no
+        // limit). After each upload, pages not drawn in the current frame are evicted, least
+        // recently drawn first, while resident pages exceed `texture_budget` bytes. An evicted
+        // page is uploaded again the next time it is drawn.
+        int64_t                      texture_budget = int64_t{256} << 20;
+        int                          max_uploads    = 0;
+        int                          uploads        = 0;  // in the current frame
+        int64_t                      resident_bytes = 0;
+        int64_t                      pages_created  = 0;  // identifies pages in draw_sprites()
+        std::set<OpenGlTexturePage*> atlas_pages;
+        void                         evict();
+
+        // Sets the hue that sprite overlays are tinted with in the current program, or -1 for
+        // none, and the offset of the overlay within the bound texture.
+        void set_tint(int hue, int overlay_offset);
+
+        // Streams `count` vertices in the format of `array`, and draws them as `mode` primitives.
+        void draw(int mode, uint32_t array, const void* vertices, size_t count);
+
+        // Scratch space for draw_sprites().
+        std::vector<SpriteVertex> sprites;
+
+        // Untextured primitives queued by batch_*() or dither_rect(), not yet drawn. Each batch
+        // has a single primitive type and color mode; `batch_mode` is 0 when nothing is queued.
+        int                      batch_mode       = 0;
+        int                      batch_color_mode = 0;
+        std::vector<ColorVertex> batch;
+
+        // Starts a batch of `mode` primitives in `color_mode`, flushing any other batch first.
+        void queue(int mode, int color_mode);
+        void push(float x, float y, const RgbColor& color);
+
+        // Draws the queued primitives with one upload and one draw call. Must be called before
+        // drawing anything else, so that everything is drawn in order.
+        void flush();
+
+      private:
+        void next_segment();
+    };
+
+    const Stats& stats() const { return _gl.stats; }
+
+    // Bounds the memory used by atlas pages, and the number uploaded per frame (0 for no limit).
+    // Offscreen rendering shouldn't limit uploads, since a sprite isn't drawn in a frame where its
+    // page couldn't be uploaded.
+    void set_texture_limits(int64_t budget, int uploads_per_frame);
+
   protected:
     class MainLoop {
       public:
@@ -87,6 +221,8 @@ class OpenGlVideoDriver : public VideoDriver {
         MainLoop& operator=(const MainLoop&) = delete;
 
         void  draw();
+        void  begin_frame();
+        void  end_frame();
         bool  done() const;
         Card* top() const;
 
@@ -115,15 +251,16 @@ class OpenGlVideoDriver : public VideoDriver {
     virtual void end_rects();
     virtual void batch_rect(const Rect& rect, const RgbColor& color);
 
-    Random _static_seed;
+    void fill_rect(const Rect& rect, const RgbColor& color, int color_mode);
 
-    Uniforms _uniforms;
+    Random _static_seed;
 
-    std::map<size_t, Texture> _triangles;
-    std::map<size_t, Texture> _diamonds;
-    std::map<size_t, Texture> _pluses;
+    Context _gl;
 
-    uint32_t _vbuf[3];
+    // Icons by shape and size, all regions of one atlas page, which is rebuilt with every shape
+    // and size seen so far whenever a new one is needed. Squares are one stretched white pixel.
+    const Texture& icon(IconInstance::Shape shape, int size);
+    std::map<std::pair<IconInstance::Shape, int>, Texture> _icons;
 };
 
 }  // namespace antares
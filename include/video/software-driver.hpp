@@ -0,0 +1,168 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_VIDEO_SOFTWARE_DRIVER_HPP_
+#define ANTARES_VIDEO_SOFTWARE_DRIVER_HPP_
+
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <pn/string>
+#include <sfz/sfz.hpp>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "config/keys.hpp"
+#include "drawing/pix-map.hpp"
+#include "drawing/y4m-writer.hpp"
+#include "math/random.hpp"
+#include "ui/event-scheduler.hpp"
+#include "video/driver.hpp"
+#include "video/expected-snapshots.hpp"
+#include "video/tee-driver.hpp"
+
+namespace antares {
+
+// Draws on the CPU into an ArrayPixMap, and writes snapshots as PNGs, so that images can be made
+// without a GL context.
+//
+// Pixels are sampled and covered as OffscreenVideoDriver's shaders would, so the two agree except
+// for rounding, within a level or two per channel where colors are blended, multiplied or tinted,
+// and except that lines are stepped rather than rasterized, which can differ by a pixel.
+//
+// Drawing only records commands; each frame is rasterized once it has been drawn, optionally in
+// horizontal bands on several threads. Commands are applied to each band in order, so the bands
+// are independent. The threads are started with the first frame, and kept for later ones.
+class SoftwareVideoDriver : public VideoDriver {
+    class MainLoop;
+
+  public:
+    SoftwareVideoDriver(
+            Size screen_size, int scale, const sfz::optional<pn::string>& output_dir);
+    ~SoftwareVideoDriver();
+
+    virtual Point     get_mouse() { return _scheduler->get_mouse(); }
+    virtual InputMode input_mode() const { return _scheduler->input_mode(); }
+    virtual int       scale() const { return _scale; }
+    virtual Size      screen_size() const { return _screen_size; }
+
+    virtual bool start_editing(TextReceiver* text);
+    virtual void stop_editing(TextReceiver* text);
+
+    virtual wall_time now() const { return _scheduler->now(); }
+
+    virtual Texture texture(pn::string_view name, const PixMap& content, int scale);
+    virtual void    dither_rect(const Rect& rect, const RgbColor& color);
+    virtual void    draw_triangle(const Rect& rect, const RgbColor& color);
+    virtual void    draw_diamond(const Rect& rect, const RgbColor& color);
+    virtual void    draw_plus(const Rect& rect, const RgbColor& color);
+
+    void loop(Card* initial, EventScheduler& scheduler);
+    void capture(std::vector<std::pair<std::unique_ptr<Card>, pn::string>>& pix);
+    void set_capture_rect(Rect r) { _capture_rect = r; }
+
+    std::unique_ptr<TeeVideoDriver::Output> tee_output();
+
+    // Snapshots are compressed with `options`, on `threads` threads (by default, one per core).
+    void set_png_options(PngOptions options, int threads = 0) {
+        _png_options = options;
+        _png_threads = threads;
+    }
+
+    // If set, snapshots are compared with `expected` instead of being written.
+    void set_expected(ExpectedSnapshots* expected) { _expected = expected; }
+
+    // Writes snapshots to `out` as the frames of a Y4M video, at `rate_num / rate_den` frames per
+    // second, instead of as PNG files. The output directory, if any, is then only used for sound.
+    void set_video_output(pn::output_view out, int rate_num, int rate_den) {
+        _video.reset(new Y4mWriter(out, rate_num, rate_den));
+    }
+
+    // Rasterizes each frame in `threads` bands at once. By default, frames are rasterized on the
+    // calling thread. Has no effect once the first frame has been rasterized.
+    void set_raster_threads(int threads) { _raster_threads = std::max(threads, 1); }
+
+  private:
+    class TextureImpl;
+
+    // A primitive, in pixels of the frame. Textured modes map `dest` onto `source`, a rect of
+    // texels within `image`.
+    //
+    // A LINE runs from (dest.left, dest.top) to (dest.right, dest.bottom). OUTLINE samples
+    // neighbors `unit_x` and `unit_y` texels away, within `bounds`, and fills with `color`.
+    struct Command {
+        enum Mode { FILL, LINE, DRAW, TINT, STATIC, OUTLINE };
+        Mode                               mode = FILL;
+        Rect                               dest;
+        Rect                               source;
+        RgbColor                           color;  // in sRGB, as are the colors below
+        RgbColor                           outline;
+        uint8_t                            frac = 0;
+        Rect                               bounds;
+        float                              unit_x = 0, unit_y = 0;
+        std::shared_ptr<const ArrayPixMap> image;
+    };
+
+    virtual void batch_point(const Point& at, const RgbColor& color);
+    virtual void batch_line(const Point& from, const Point& to, const RgbColor& color);
+    virtual void batch_rect(const Rect& rect, const RgbColor& color);
+
+    void fill(const Rect& rect, const RgbColor& color);
+    void draw_icon(IconInstance::Shape shape, const Rect& rect, const RgbColor& color);
+    void push(Command command);
+
+    void rasterize();
+    void rasterize(int32_t top, int32_t bottom);
+    void rasterize_band(int band);  // runs on the worker for `band`, until stopped
+
+    const Size                 _screen_size;
+    const int                  _scale;
+    sfz::optional<pn::string>  _output_dir;
+    Rect                       _capture_rect;
+    PngOptions                 _png_options;
+    int                        _png_threads    = 0;
+    int                        _raster_threads = 1;
+    std::unique_ptr<Y4mWriter> _video;
+    ExpectedSnapshots*         _expected       = nullptr;
+
+    ArrayPixMap          _frame;
+    std::vector<Command> _commands;
+    Random               _static_seed;
+    int32_t              _seed = 0;
+    std::vector<uint8_t> _static;  // 256x256 noise values, for STATIC
+
+    // Icons by shape and size, white on clear, as OpenGlVideoDriver draws them.
+    std::map<std::pair<IconInstance::Shape, int>, std::shared_ptr<const ArrayPixMap>> _icons;
+
+    EventScheduler* _scheduler = nullptr;
+
+    // Workers for bands 1 and up; the calling thread does band 0.
+    int                      _bands = 0;  // of every frame, once started
+    std::mutex               _raster_mutex;
+    std::condition_variable  _raster_changed;       // notified whenever any of the below change
+    int64_t                  _raster_frames   = 0;  // started, ever
+    int                      _raster_pending  = 0;  // bands of the current frame not yet done
+    bool                     _raster_stopping = false;
+    std::vector<std::thread> _raster_workers;
+};
+
+}  // namespace antares
+
+#endif  // ANTARES_VIDEO_SOFTWARE_DRIVER_HPP_
@@ -0,0 +1,149 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#ifndef ANTARES_VIDEO_TEE_DRIVER_HPP_
+#define ANTARES_VIDEO_TEE_DRIVER_HPP_
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "ui/card.hpp"
+#include "ui/event-scheduler.hpp"
+#include "video/driver.hpp"
+
+namespace antares {
+
+// Forwards every draw call to several drivers, so that one run can produce, for example, both a
+// text log and PNG snapshots, each in its own output directory.
+//
+// Drivers are added with add(), which constructs them; a driver can't be constructed directly
+// while another exists. The first driver added decides the screen size and scale.
+class TeeVideoDriver : public VideoDriver {
+    class MainLoop;
+
+  public:
+    // A driver's part in running the tee's frames: what it does before and after the cards draw
+    // each frame, and its snapshots of the frame.
+    class Output {
+      public:
+        virtual ~Output() {}
+        virtual bool takes_snapshots()          = 0;
+        virtual void begin_frame()              = 0;
+        virtual void end_frame()                = 0;
+        virtual void snapshot(wall_ticks ticks) = 0;
+        virtual void finish()                   = 0;
+    };
+
+    // An Output that runs a driver's own main loop, a `Loop` constructed with `args` and a card.
+    // The tee owns the cards, so the loop's stack holds only an empty card, which isn't drawn.
+    template <typename Loop>
+    class LoopOutput : public Output {
+      public:
+        template <typename... Args>
+        LoopOutput(Args&&... args) : _loop(std::forward<Args>(args)..., new Card) {}
+
+        virtual bool takes_snapshots() { return _loop.takes_snapshots(); }
+        virtual void begin_frame() { _loop.begin_frame(); }
+        virtual void end_frame() { _loop.end_frame(); }
+        virtual void snapshot(wall_ticks ticks) { _loop.snapshot(ticks); }
+        virtual void finish() { _loop.finish(); }
+
+      private:
+        Loop _loop;
+    };
+
+    // Constructs a `T` from `args`, and draws to it. `T` must have a method tee_output(), which
+    // returns its Output.
+    template <typename T, typename... Args>
+    T& add(Args&&... args) {
+        detach();
+        std::unique_ptr<T> driver;
+        try {
+            driver.reset(new T(std::forward<Args>(args)...));
+        } catch (...) {
+            attach();
+            throw;
+        }
+        attach();
+        T& result = *driver;
+        _drivers.push_back(Driver{std::move(driver), [&result] { return result.tee_output(); }});
+        return result;
+    }
+
+    virtual Point     get_mouse() { return _scheduler->get_mouse(); }
+    virtual InputMode input_mode() const { return _scheduler->input_mode(); }
+    virtual int       scale() const;
+    virtual Size      screen_size() const;
+
+    virtual bool start_editing(TextReceiver* text);
+    virtual void stop_editing(TextReceiver* text);
+
+    virtual wall_time now() const { return _scheduler->now(); }
+
+    virtual Texture      texture(pn::string_view name, const PixMap& content, int scale);
+    virtual TextureAtlas atlas(Size size, AtlasLoader load);
+    virtual int64_t      atlas_bytes() const;
+    virtual void         dither_rect(const Rect& rect, const RgbColor& color);
+    virtual void         draw_triangle(const Rect& rect, const RgbColor& color);
+    virtual void         draw_diamond(const Rect& rect, const RgbColor& color);
+    virtual void         draw_plus(const Rect& rect, const RgbColor& color);
+    virtual void         draw_sprites(const std::vector<SpriteInstance>& sprites);
+    virtual void         draw_icons(const std::vector<IconInstance>& icons);
+
+    void loop(Card* initial, EventScheduler& scheduler);
+
+  private:
+    class TextureImpl;
+    class TextureAtlasImpl;
+
+    struct Driver {
+        std::unique_ptr<VideoDriver>             driver;
+        std::function<std::unique_ptr<Output>()> output;
+    };
+
+    virtual void begin_points();
+    virtual void end_points();
+    virtual void batch_point(const Point& at, const RgbColor& color);
+
+    virtual void begin_lines();
+    virtual void end_lines();
+    virtual void batch_line(const Point& from, const Point& to, const RgbColor& color);
+
+    virtual void begin_rects();
+    virtual void end_rects();
+    virtual void batch_rect(const Rect& rect, const RgbColor& color);
+
+    // While detached, no driver is current, so that another can be constructed.
+    void detach();
+    void attach();
+
+    // Calls `fn` with each driver and its index, making that driver current meanwhile, so that
+    // whatever it draws through Points, Lines or Rects reaches it alone.
+    template <typename Fn>
+    void each(Fn fn);
+
+    std::vector<Driver>         _drivers;
+    std::vector<SpriteInstance> _sprites;  // scratch space for draw_sprites()
+
+    EventScheduler* _scheduler = nullptr;
+};
+
+}  // namespace antares
+
+#endif  // ANTARES_VIDEO_TEE_DRIVER_HPP_
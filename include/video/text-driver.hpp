@@ -19,12 +19,16 @@
 #ifndef ANTARES_VIDEO_TEXT_DRIVER_HPP_
 #define ANTARES_VIDEO_TEXT_DRIVER_HPP_
 
+#include <map>
 #include <sfz/sfz.hpp>
 #include <vector>
 
 #include "config/keys.hpp"
 #include "ui/event-scheduler.hpp"
+#include "video/draw-log.hpp"
 #include "video/driver.hpp"
+#include "video/expected-snapshots.hpp"
+#include "video/tee-driver.hpp"
 
 namespace antares {
 
@@ -48,29 +52,44 @@ class TextVideoDriver : public VideoDriver {
     virtual void    draw_diamond(const Rect& rect, const RgbColor& color);
     virtual void    draw_plus(const Rect& rect, const RgbColor& color);
 
+    // Only logs texture names and sizes, so sprite images are never decoded.
+    virtual TextureAtlas atlas(Size size, AtlasLoader load);
+
+    // If true, snapshots are written as binary logs (.bin), which are quicker to produce and
+    // smaller; see decode_draw_log(). By default, they are written as text (.txt).
+    void set_binary_log(bool binary) { _binary = binary; }
+
+    // If set, snapshots are compared with `expected` instead of being written.
+    void set_expected(ExpectedSnapshots* expected) { _expected = expected; }
+
     void loop(Card* initial, EventScheduler& scheduler);
     void capture(std::vector<std::pair<std::unique_ptr<Card>, pn::string>>& pix);
 
+    std::unique_ptr<TeeVideoDriver::Output> tee_output();
+
   private:
     class MainLoop;
     class TextureImpl;
+    class TextureAtlasImpl;
 
     virtual void batch_point(const Point& at, const RgbColor& color);
     virtual void batch_line(const Point& from, const Point& to, const RgbColor& color);
     virtual void batch_rect(const Rect& rect, const RgbColor& color);
 
-    void            add_arg(pn::string_view arg, std::vector<std::pair<size_t, size_t>>& args);
-    void            dup_arg(size_t index, std::vector<std::pair<size_t, size_t>>& args);
-    pn::string_view last_arg(size_t index) const;
-
     template <typename... Args>
-    void log(pn::string_view command, const Args&... args);
+    void log(DrawOp op, const Args&... args);
+
+    // The id of `name` in the draw log. Textures that share a name share an id.
+    uint32_t name_id(pn::string_view name);
 
     const Size                _size;
     sfz::optional<pn::string> _output_dir;
+    ExpectedSnapshots*        _expected = nullptr;
 
-    pn::string                             _log;
-    std::vector<std::pair<size_t, size_t>> _last_args;
+    bool                           _binary = false;
+    TextDrawLog                    _text;
+    BinaryDrawLog                  _binary_log;
+    std::map<pn::string, uint32_t> _name_ids;
 
     EventScheduler* _scheduler = nullptr;
 };
@@ -31,6 +31,10 @@ WINE_TESTS = [
     "tint",
 ]
 
+# SoftwareVideoDriver rounds differently from OpenGL, by a level or two per channel where colors
+# are blended, multiplied or tinted, so its screenshots are compared with this tolerance.
+SOFTWARE_TOLERANCE = 2
+
 
 def run(opts, queue, name, cmd):
     if cmd[0].startswith("out/cur/") and not os.path.islink("out/cur"):
@@ -55,13 +59,18 @@ def unit_test(opts, queue, name, args=[]):
     return run(opts, queue, name, ["out/cur/%s" % name] + args)
 
 
-def diff_test(opts, queue, name, cmd, expected):
+def diff_test(opts, queue, name, cmd, expected, expect_screens=False):
+    exclude = ["-x.*"]
+    if expect_screens and not opts.smoke:
+        # The binary compares screenshots itself, as it takes them; only the rest is diffed.
+        cmd = cmd + ["--expect=%s" % expected]
+        exclude.append("-xscreens")
     with NamedTemporaryDir() as d:
         return run(opts, queue, name, cmd + ["--output=%s" % d]) and run(
             opts,
             queue,
             name,
-            ["diff", "--strip-trailing-cr", "-ru", "-x.*", expected, d],
+            ["diff", "--strip-trailing-cr", "-ru"] + exclude + [expected, d],
         )
 
 
@@ -81,7 +90,9 @@ def offscreen_test(opts, queue, name, args=[]):
         expected = "test/smoke/%s" % name
     else:
         expected = "test/%s" % name
-    return diff_test(opts, queue, name, cmd + args, expected)
+        if opts.software:
+            cmd += ["--software", "--tolerance=%d" % SOFTWARE_TOLERANCE]
+    return diff_test(opts, queue, name, cmd + args, expected, expect_screens=True)
 
 
 def replay_test(opts, queue, name, args=[]):
@@ -91,7 +102,7 @@ def replay_test(opts, queue, name, args=[]):
         expected = "test/smoke/%s" % name
     else:
         expected = "test/%s" % name
-    return diff_test(opts, queue, name, cmd + args, expected)
+    return diff_test(opts, queue, name, cmd + args, expected, expect_screens=True)
 
 
 def call(args):
@@ -142,6 +153,7 @@ def main():
     parser.add_argument("--smoke", action="store_true")
     parser.add_argument("--wine", action="store_true")
     parser.add_argument("--opengl", choices=["2.0", "3.2"])
+    parser.add_argument("--software", action="store_true")
     parser.add_argument("-t", "--type", action="append", choices=test_types)
     parser.add_argument("test", nargs="*")
     opts = parser.parse_args()
@@ -154,8 +166,11 @@ def main():
     pool = multiprocessing.pool.ThreadPool()
     tests = [
         (unit_test, opts, queue, "color-test"),
+        (unit_test, opts, queue, "draw-log-test"),
         (unit_test, opts, queue, "editable-text-test"),
         (unit_test, opts, queue, "fixed-test"),
+        (unit_test, opts, queue, "simulation-test"),
+        (unit_test, opts, queue, "y4m-writer-test"),
         (data_test, opts, queue, "build-pix", ["--text"]),
         (data_test, opts, queue, "object-data"),
         (data_test, opts, queue, "shapes"),
@@ -190,6 +205,10 @@ def main():
     if opts.opengl:
         tests = [t for t in tests if opengl in t]
 
+    if opts.software:
+        # Only screenshots depend on the driver; run the offscreen tests that take them.
+        tests = [t for t in tests if (t[0] == offscreen_test) and ("--text" not in t[4])]
+
     if opts.type:
         if "unit" not in opts.type:
             tests = [t for t in tests if t[0] != unit_test]
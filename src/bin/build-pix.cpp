@@ -80,19 +80,19 @@ void usage(pn::output_view out, pn::string_view progname, int retcode) {
     exit(retcode);
 }
 
-pn::string_view intro() { return *plug.info.intro; }
+pn::string_view intro() { return *plug.data->info.intro; }
 
-pn::string_view about() { return *plug.info.about; }
+pn::string_view about() { return *plug.data->info.about; }
 
 std::function<pn::string_view()> prologue(pn::string_view chapter) {
     return [chapter]() -> pn::string_view {
-        return *plug.levels.find(chapter.copy())->second.solo.prologue;
+        return *plug.data->levels.find(chapter.copy())->second.solo.prologue;
     };
 }
 
 std::function<pn::string_view()> epilogue(pn::string_view chapter) {
     return [chapter]() -> pn::string_view {
-        return *plug.levels.find(chapter.copy())->second.solo.epilogue;
+        return *plug.data->levels.find(chapter.copy())->second.solo.epilogue;
     };
 }
 
@@ -0,0 +1,100 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include <pn/output>
+#include <sfz/sfz.hpp>
+#include <vector>
+
+#include "lang/exception.hpp"
+#include "video/draw-log.hpp"
+
+namespace args = sfz::args;
+
+namespace antares {
+namespace {
+
+void usage(pn::output_view out, pn::string_view progname, int retcode) {
+    out.format(
+            "usage: {0} [OPTIONS] file...\n"
+            "\n"
+            "  Prints binary draw logs (from replay --binary-log) as text\n"
+            "\n"
+            "  arguments:\n"
+            "    file                a binary draw log\n"
+            "\n"
+            "  options:\n"
+            "    -w, --write         write each file's text next to it, as .txt instead of .bin\n"
+            "    -h, --help          display this help screen\n",
+            progname);
+    exit(retcode);
+}
+
+void main(int argc, char* const* argv) {
+    args::callbacks callbacks;
+
+    std::vector<pn::string> files;
+    callbacks.argument = [&files](pn::string_view arg) {
+        files.push_back(arg.copy());
+        return true;
+    };
+
+    bool write             = false;
+    callbacks.short_option = [&argv, &write](
+                                     pn::rune opt, const args::callbacks::get_value_f& get_value) {
+        switch (opt.value()) {
+            case 'w': write = true; return true;
+            case 'h': usage(pn::out, sfz::path::basename(argv[0]), 0); return true;
+            default: return false;
+        }
+    };
+
+    callbacks.long_option =
+            [&callbacks](pn::string_view opt, const args::callbacks::get_value_f& get_value) {
+                if (opt == "write") {
+                    return callbacks.short_option(pn::rune{'w'}, get_value);
+                } else if (opt == "help") {
+                    return callbacks.short_option(pn::rune{'h'}, get_value);
+                } else {
+                    return false;
+                }
+            };
+
+    args::parse(argc - 1, argv + 1, callbacks);
+    if (files.empty()) {
+        throw std::runtime_error("missing required argument 'file'");
+    }
+
+    for (const pn::string& path : files) {
+        sfz::mapped_file file(path);
+        pn::string       text = decode_draw_log(file.data());
+        if (!write) {
+            pn::out.write(text);
+            continue;
+        }
+        pn::string_view stem = path;
+        if ((stem.size() >= 4) && (stem.substr(stem.size() - 4) == ".bin")) {
+            stem = stem.substr(0, stem.size() - 4);
+        }
+        pn::output out{pn::format("{0}.txt", stem), pn::binary};
+        out.write(text);
+    }
+}
+
+}  // namespace
+}  // namespace antares
+
+int main(int argc, char* const* argv) { return antares::wrap_main(antares::main, argc, argv); }
@@ -28,7 +28,10 @@
 #include "ui/card.hpp"
 #include "ui/flows/master.hpp"
 #include "video/driver.hpp"
+#include "video/expected-snapshots.hpp"
 #include "video/offscreen-driver.hpp"
+#include "video/software-driver.hpp"
+#include "video/tee-driver.hpp"
 #include "video/text-driver.hpp"
 
 using sfz::makedirs;
@@ -61,7 +64,17 @@ void usage(pn::output_view out, pn::string_view progname, int retcode) {
             "\n  options:"
             "\n    -o, --output=OUTPUT  place output in this directory"
             "\n    -t, --text           produce text output"
+            "\n        --expect=DIR     compare screenshots with those in DIR as they are taken,"
+            "\n                         and stop at the first that doesn't match"
+            "\n        --keep-going     with --expect, compare every screenshot, and write those"
+            "\n                         that don't match to OUTPUT, with a diff of each image"
+            "\n        --tolerance=N    with --expect, let each channel of each pixel differ from"
+            "\n                         the screenshot in DIR by up to N (default: 0)"
+            "\n        --text-output=DIR"
+            "\n                         also produce text output in DIR, from the same run as"
+            "\n                         the screenshots"
             "\n        --opengl=2.0|3.2 select OpenGL version (default: 3.2)"
+            "\n        --software       draw on the CPU, without OpenGL"
             "\n    -h, --help           display this help screen"
             "\n",
             progname);
@@ -82,7 +95,12 @@ void main(int argc, char* const* argv) {
     };
 
     sfz::optional<pn::string> output_dir;
+    sfz::optional<pn::string> text_output;
+    sfz::optional<pn::string> expect_dir;
+    bool                      keep_going   = false;
+    int                       tolerance    = 0;
     bool                      text         = false;
+    bool                      software     = false;
     std::pair<int, int>       gl_version   = {3, 2};
     pn::string_view           glsl_version = "330 core";
     callbacks.short_option = [&](pn::rune opt, const args::callbacks::get_value_f& get_value) {
@@ -100,6 +118,21 @@ void main(int argc, char* const* argv) {
             return callbacks.short_option(pn::rune{'o'}, get_value);
         } else if (opt == "text") {
             return callbacks.short_option(pn::rune{'t'}, get_value);
+        } else if (opt == "expect") {
+            expect_dir.emplace(get_value().copy());
+            return true;
+        } else if (opt == "keep-going") {
+            keep_going = true;
+            return true;
+        } else if (opt == "tolerance") {
+            sfz::args::integer_option(get_value(), &tolerance);
+            return true;
+        } else if (opt == "text-output") {
+            text_output.emplace(get_value().copy());
+            return true;
+        } else if (opt == "software") {
+            software = true;
+            return true;
         } else if (opt == "opengl") {
             if (get_value() == "2.0") {
                 gl_version   = {2, 0};
@@ -119,10 +152,18 @@ void main(int argc, char* const* argv) {
     };
 
     args::parse(argc - 1, argv + 1, callbacks);
+    if (text && text_output.has_value()) {
+        throw std::runtime_error("--text-output can't be used with --text");
+    } else if (expect_dir.has_value() && text_output.has_value()) {
+        throw std::runtime_error("--expect can't be used with --text-output");
+    }
 
     if (output_dir.has_value()) {
         makedirs(*output_dir, 0755);
     }
+    if (text_output.has_value()) {
+        makedirs(*text_output, 0755);
+    }
 
     NullPrefsDriver prefs;
     EventScheduler  scheduler;
@@ -152,15 +193,41 @@ void main(int argc, char* const* argv) {
         sound.reset(new NullSoundDriver);
     }
 
+    unique_ptr<ExpectedSnapshots> expected;
+    if (expect_dir.has_value()) {
+        expected.reset(new ExpectedSnapshots(*expect_dir, output_dir, keep_going, tolerance));
+    }
+
     if (text) {
         TextVideoDriver video({640, 480}, output_dir);
+        video.set_expected(expected.get());
+        video.loop(new Master(sfz::nullopt, 14586), scheduler);
+    } else if (text_output.has_value()) {
+        TeeVideoDriver video;
+        if (software) {
+            video.add<SoftwareVideoDriver>(Size{640, 480}, 1, output_dir);
+        } else {
+#ifndef _WIN32
+            video.add<OffscreenVideoDriver>(
+                    Size{640, 480}, 1, gl_version, glsl_version, output_dir);
+#endif
+        }
+        video.add<TextVideoDriver>(Size{640, 480}, text_output);
+        video.loop(new Master(sfz::nullopt, 14586), scheduler);
+    } else if (software) {
+        SoftwareVideoDriver video({640, 480}, 1, output_dir);
+        video.set_expected(expected.get());
         video.loop(new Master(sfz::nullopt, 14586), scheduler);
     } else {
 #ifndef _WIN32
         OffscreenVideoDriver video({640, 480}, 1, gl_version, glsl_version, output_dir);
+        video.set_expected(expected.get());
         video.loop(new Master(sfz::nullopt, 14586), scheduler);
 #endif
     }
+    if (expected) {
+        expected->finish();
+    }
 }
 
 void fast_motion(EventScheduler& scheduler) {
@@ -187,9 +254,7 @@ void fast_motion(EventScheduler& scheduler) {
 
     scheduler.schedule_key(Key::N5, 2020, 2400);
     scheduler.schedule_key(Key::F6, 2020, 2400);
-    for (int i = 2200; i < 2290; i += 10) {
-        scheduler.schedule_snapshot(i);
-    }
+    scheduler.schedule_snapshots(2200, 10, 2290);
 
     scheduler.schedule_snapshot(2400);
 
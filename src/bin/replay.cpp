@@ -18,8 +18,12 @@
 
 #include "data/replay.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <pn/output>
 #include <sfz/sfz.hpp>
+#include <thread>
 
 #include "config/dirs.hpp"
 #include "config/ledger.hpp"
@@ -37,9 +41,11 @@
 #include "game/labels.hpp"
 #include "game/level.hpp"
 #include "game/main.hpp"
+#include "game/memory-report.hpp"
 #include "game/messages.hpp"
 #include "game/motion.hpp"
 #include "game/space-object.hpp"
+#include "game/state-dump.hpp"
 #include "game/sys.hpp"
 #include "game/vector.hpp"
 #include "lang/exception.hpp"
@@ -51,7 +57,10 @@
 #include "ui/interface-handling.hpp"
 #include "ui/screens/debriefing.hpp"
 #include "video/driver.hpp"
+#include "video/expected-snapshots.hpp"
 #include "video/offscreen-driver.hpp"
+#include "video/software-driver.hpp"
+#include "video/tee-driver.hpp"
 #include "video/text-driver.hpp"
 
 using std::unique_ptr;
@@ -62,17 +71,76 @@ namespace path = sfz::path;
 namespace antares {
 namespace {
 
+// Plays back a replay until `dump_at`, then writes the simulation state and ends the game.
+//
+// The state is written when input is read for the first major tick at or after `dump_at`, that
+// is, after objects have moved and thought but before collisions are checked. If the game ends
+// first, nothing is written, and dumped() stays false.
+class StateDumpInputSource : public InputSource {
+  public:
+    StateDumpInputSource(
+            ReplayData* data, game_ticks dump_at, const sfz::optional<pn::string>& output_path)
+            : _replay(data), _dump_at(dump_at) {
+        if (output_path.has_value()) {
+            _output_path.emplace(output_path->copy());
+        }
+    }
+
+    virtual void start() { _replay.start(); }
+
+    virtual bool get(Handle<Admiral> admiral, game_ticks at, EventReceiver& key_map) {
+        if (at < _dump_at) {
+            return _replay.get(admiral, at, key_map);
+        }
+        _dumped = true;
+        if (_output_path.has_value()) {
+            pn::string path = pn::format("{0}/state.txt", *_output_path);
+            sfz::makedirs(path::dirname(path), 0755);
+            pn::output out{path, pn::text};
+            dump_state(out);
+        } else {
+            dump_state(pn::out);
+        }
+        return false;
+    }
+
+    virtual void key_down(const KeyDownEvent& event) { _replay.key_down(event); }
+    virtual void gamepad_button_down(const GamepadButtonDownEvent& event) {
+        _replay.gamepad_button_down(event);
+    }
+    virtual void mouse_down(const MouseDownEvent& event) { _replay.mouse_down(event); }
+
+    game_ticks dump_at() const { return _dump_at; }
+    bool       dumped() const { return _dumped; }
+
+  private:
+    ReplayInputSource         _replay;
+    const game_ticks          _dump_at;
+    sfz::optional<pn::string> _output_path;
+    bool                      _dumped = false;
+};
+
 class ReplayMaster : public Card {
   public:
-    ReplayMaster(pn::input_view in, const sfz::optional<pn::string>& output_path)
+    ReplayMaster(
+            pn::input_view in, const sfz::optional<pn::string>& output_path,
+            sfz::optional<int64_t> dump_at, std::shared_ptr<ScenarioData> scenario,
+            GameResult* game_result)
             : _state(NEW),
               _replay_data(in),
               _random_seed(_replay_data.global_seed),
-              _game_result(NO_GAME),
-              _input_source(&_replay_data) {
+              _scenario(std::move(scenario)),
+              _game_result(game_result) {
         if (output_path.has_value()) {
             _output_path.emplace(output_path->copy());
         }
+        if (dump_at.has_value()) {
+            _state_dump = new StateDumpInputSource(
+                    &_replay_data, game_ticks(ticks(*dump_at)), _output_path);
+            _input_source.reset(_state_dump);
+        } else {
+            _input_source.reset(new ReplayInputSource(&_replay_data));
+        }
     }
 
     virtual void become_front() {
@@ -81,21 +149,29 @@ class ReplayMaster : public Card {
                 _state = REPLAY;
                 init();
                 Randomize(4);  // For the decision to replay intro.
-                _game_result  = NO_GAME;
+                *_game_result = NO_GAME;
                 g.random.seed = _random_seed;
                 stack()->push(new MainPlay(
-                        *Level::get(_replay_data.chapter_id), true, &_input_source, false,
-                        &_game_result));
+                        *Level::get(_replay_data.chapter_id), true, _input_source.get(), false,
+                        _game_result));
                 break;
 
             case REPLAY:
+                if (_state_dump && !_state_dump->dumped()) {
+                    throw std::runtime_error(
+                            pn::format(
+                                    "replay ended at tick {0}, before --dump-state={1}",
+                                    g.time.time_since_epoch().count(),
+                                    _state_dump->dump_at().time_since_epoch().count())
+                                    .c_str());
+                }
                 if (_output_path.has_value()) {
                     pn::string path = pn::format("{0}/debriefing.txt", *_output_path);
                     sfz::makedirs(path::dirname(path), 0755);
                     pn::output outcome{path, pn::text};
                     if (g.victory_text.has_value()) {
                         outcome.write(*g.victory_text);
-                        if (_game_result == WIN_GAME) {
+                        if (*_game_result == WIN_GAME) {
                             outcome.write("\n");
                             Handle<Admiral> player(0);
                             pn::string      text = DebriefingScreen::build_score_text(
@@ -121,11 +197,13 @@ class ReplayMaster : public Card {
     };
     State _state;
 
-    sfz::optional<pn::string> _output_path;
-    ReplayData                _replay_data;
-    const int32_t             _random_seed;
-    GameResult                _game_result;
-    ReplayInputSource         _input_source;
+    sfz::optional<pn::string>     _output_path;
+    ReplayData                    _replay_data;
+    const int32_t                 _random_seed;
+    std::shared_ptr<ScenarioData> _scenario;
+    GameResult* const             _game_result;
+    unique_ptr<InputSource>       _input_source;
+    StateDumpInputSource*         _state_dump = nullptr;  // owned by _input_source, if dumping
 };
 
 void ReplayMaster::init() {
@@ -138,12 +216,158 @@ void ReplayMaster::init() {
     Messages::init();
     InstrumentInit();
     SpriteHandlingInit();
-    PluginInit(sfz::nullopt);
+    PluginInit(sfz::nullopt, _scenario);
     SpaceObjectHandlingInit();  // MUST be after PluginInit()
     Admiral::init();
     Vectors::init();
 }
 
+// Collects the paths of all replays below a directory.
+class ReplayLister : public sfz::TreeWalker {
+  public:
+    explicit ReplayLister(std::vector<pn::string>* paths) : _paths(paths) {}
+
+    void file(pn::string_view name, const sfz::Stat& st) const override {
+        pn::string_view extension = ".NLRP";
+        if ((name.size() > extension.size()) &&
+            (name.substr(name.size() - extension.size()) == extension)) {
+            _paths->push_back(name.copy());
+        }
+    }
+
+    void pre_directory(pn::string_view name, const sfz::Stat& st) const override {}
+    void cycle_directory(pn::string_view name, const sfz::Stat& st) const override {}
+    void post_directory(pn::string_view name, const sfz::Stat& st) const override {}
+    void symlink(pn::string_view name, const sfz::Stat& st) const override {}
+    void broken_symlink(pn::string_view name, const sfz::Stat& st) const override {}
+    void other(pn::string_view name, const sfz::Stat& st) const override {}
+
+  private:
+    std::vector<pn::string>* _paths;
+};
+
+struct BatchResult {
+    GameResult                game_result = NO_GAME;
+    int64_t                   final_tick  = 0;
+    pn::string                digest;
+    int64_t                   wall_ms = 0;
+    sfz::optional<pn::string> error;
+};
+
+const char* stringify(GameResult result) {
+    switch (result) {
+        case NO_GAME: return "none";
+        case LOSE_GAME: return "lose";
+        case WIN_GAME: return "win";
+        case RESTART_GAME: return "restart";
+        case QUIT_GAME: return "quit";
+    }
+    return "?";
+}
+
+// Plays one replay to the end on the calling thread, with its own drivers and game state.
+BatchResult play_one(pn::string_view path, Size size, std::shared_ptr<ScenarioData> scenario) {
+    using std::chrono::steady_clock;
+    const auto  start = steady_clock::now();
+    BatchResult result;
+    try {
+        Preferences preferences;
+        preferences.play_music_in_game = true;
+        NullPrefsDriver prefs(preferences.copy());
+        NullSoundDriver sound;
+        NullLedger      ledger;
+
+        EventScheduler scheduler;
+        scheduler.schedule_event(
+                unique_ptr<Event>(new MouseMoveEvent(wall_time(), Point(320, 240))));
+
+        pn::input       replay_file{path, pn::binary};
+        TextVideoDriver video(size, sfz::optional<pn::string>());
+        video.loop(
+                new ReplayMaster(
+                        replay_file, sfz::optional<pn::string>(), sfz::nullopt,
+                        std::move(scenario), &result.game_result),
+                scheduler);
+
+        pn::data state;
+        dump_state(state.output());
+        sfz::sha1 sha;
+        sha.write(state);
+        result.final_tick = g.time.time_since_epoch().count();
+        result.digest     = sha.compute().hex();
+    } catch (std::exception& e) {
+        result.error.emplace(full_exception_string(e));
+    }
+    result.wall_ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(steady_clock::now() - start)
+                    .count();
+    return result;
+}
+
+// Plays every replay below `dir` on `jobs` threads, and writes one tab-separated line per replay
+// (path, outcome, final tick, state digest, wall time in ms) to OUTPUT/summary.tsv, or stdout.
+//
+// Scenario data is parsed once, on this thread, and shared by all workers, as is the rotation
+// table (see sys_init()). Everything else is set up again for each replay, by
+// ReplayMaster::init(): fonts, labels, sprites and the rest of sys_init() and PluginInit(). The
+// game state is thread-local, and fonts and sprites are textures of the replay's own video
+// driver, so none of it can be handed from one replay to another.
+void play_batch(
+        pn::string_view dir, int jobs, Size size, const sfz::optional<pn::string>& output_dir) {
+    std::vector<pn::string> paths;
+    sfz::walk(dir, sfz::WALK_PHYSICAL, ReplayLister(&paths));
+    std::sort(paths.begin(), paths.end());
+
+    std::shared_ptr<ScenarioData> scenario;
+    {
+        NullPrefsDriver prefs;
+        TextVideoDriver video(size, sfz::optional<pn::string>());
+        PluginInit(sfz::nullopt);
+        scenario = plug.data;
+    }
+
+    std::vector<BatchResult> results(paths.size());
+    std::atomic<size_t>      next{0};
+    std::vector<std::thread> workers;
+    for (int i = 0; i < std::max(jobs, 1); ++i) {
+        workers.emplace_back([&paths, &results, &next, size, scenario] {
+            size_t j;
+            while ((j = next++) < paths.size()) {
+                results[j] = play_one(paths[j], size, scenario);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    int  failures      = 0;
+    auto write_summary = [&](pn::output_view out) {
+        for (size_t i : sfz::range(paths.size())) {
+            const BatchResult& r = results[i];
+            if (r.error.has_value()) {
+                pn::err.format("{0}: {1}\n", paths[i], *r.error);
+                ++failures;
+            }
+            out.format(
+                    "{0}\t{1}\t{2}\t{3}\t{4}\n", paths[i],
+                    r.error.has_value() ? "error" : stringify(r.game_result), r.final_tick,
+                    r.digest.empty() ? pn::string_view{"-"} : pn::string_view{r.digest},
+                    r.wall_ms);
+        }
+    };
+    if (output_dir.has_value()) {
+        pn::output out{pn::format("{0}/summary.tsv", *output_dir), pn::text};
+        write_summary(out);
+    } else {
+        write_summary(pn::out);
+    }
+    if (failures) {
+        throw std::runtime_error(
+                pn::format("{0} of {1} replays failed", failures, int64_t(paths.size())).c_str());
+    }
+}
+
 void usage(pn::output_view out, pn::string_view progname, int retcode) {
     out.format(
             "usage: {0} [OPTIONS]"
@@ -152,6 +376,7 @@ void usage(pn::output_view out, pn::string_view progname, int retcode) {
             "\n"
             "\n  arguments:"
             "\n    replay              an Antares replay script"
+            "\n                        (omitted with --batch)"
             "\n"
             "\n  options:"
             "\n    -o, --output=OUTPUT  place output in this directory"
@@ -161,7 +386,35 @@ void usage(pn::output_view out, pn::string_view progname, int retcode) {
             "\n    -h, --height=HEIGHT  screen height (default: 480)"
             "\n    -t, --text           produce text output"
             "\n    -s, --smoke          run as smoke text"
+            "\n        --binary-log     with --text, --smoke or --text-output, log draw commands"
+            "\n                         in binary; see decode-draw-log"
+            "\n        --expect=DIR     compare screenshots with those in DIR as they are taken,"
+            "\n                         and stop at the first that doesn't match"
+            "\n        --keep-going     with --expect, compare every screenshot, and write those"
+            "\n                         that don't match to OUTPUT, with a diff of each image"
+            "\n        --tolerance=N    with --expect, let each channel of each pixel differ from"
+            "\n                         the screenshot in DIR by up to N (default: 0)"
+            "\n        --text-output=DIR"
+            "\n                         also produce text output in DIR, from the same run as"
+            "\n                         the screenshots"
+            "\n    -d, --dump-state=TICKS"
+            "\n                         stop at this game tick and dump the simulation state"
+            "\n                         to OUTPUT/state.txt (or stdout); see scripts/state-diff"
+            "\n    -b, --batch=DIR      play every replay in DIR without rendering, and"
+            "\n                         write a summary to OUTPUT/summary.tsv (or stdout)"
+            "\n    -j, --jobs=N         play N replays at once with --batch (default: 1)"
             "\n        --opengl=2.0|3.2 select OpenGL version (default: 3.2)"
+            "\n        --software       draw screenshots on the CPU, without OpenGL"
+            "\n        --raster-threads=N"
+            "\n                         with --software, draw each frame on N threads (default: 1)"
+            "\n        --video=FILE     write screenshots to FILE (- for stdout) as a Y4M video,"
+            "\n                         at one frame per interval, instead of as PNGs"
+            "\n        --png-level=LEVEL"
+            "\n                         zlib level for snapshots, 0-9 (default: 6)"
+            "\n        --png-filter=none|sub|up|average|paeth"
+            "\n                         PNG filter for snapshots (default: chosen per row)"
+            "\n        --gl-stats       print counts of GL calls per frame to stderr"
+            "\n        --memory         print memory use by subsystem to stderr at exit"
             "\n        --help           display this help screen"
             "\n",
             progname);
@@ -182,13 +435,27 @@ void main(int argc, char* const* argv) {
     };
 
     sfz::optional<pn::string> output_dir;
-    int                       interval     = 60;
-    int                       width        = 640;
-    int                       height       = 480;
-    bool                      text         = false;
-    bool                      smoke        = false;
-    std::pair<int, int>       gl_version   = {3, 2};
-    pn::string_view           glsl_version = "330 core";
+    int                       interval       = 60;
+    int                       width          = 640;
+    int                       height         = 480;
+    bool                      text           = false;
+    bool                      smoke          = false;
+    bool                      binary_log     = false;
+    bool                      software       = false;
+    int                       raster_threads = 1;
+    bool                      gl_stats       = false;
+    bool                      memory         = false;
+    sfz::optional<int64_t>    dump_at;
+    sfz::optional<pn::string> batch_dir;
+    int                       jobs           = 1;
+    std::pair<int, int>       gl_version     = {3, 2};
+    pn::string_view           glsl_version   = "330 core";
+    PngOptions                png_options;
+    sfz::optional<pn::string> video_path;
+    sfz::optional<pn::string> text_output;
+    sfz::optional<pn::string> expect_dir;
+    bool                      keep_going = false;
+    int                       tolerance  = 0;
     callbacks.short_option = [&](pn::rune opt, const args::callbacks::get_value_f& get_value) {
         switch (opt.value()) {
             case 'o': output_dir.emplace(get_value().copy()); return true;
@@ -197,6 +464,14 @@ void main(int argc, char* const* argv) {
             case 'h': sfz::args::integer_option(get_value(), &height); return true;
             case 't': text = true; return true;
             case 's': smoke = true; return true;
+            case 'b': batch_dir.emplace(get_value().copy()); return true;
+            case 'j': sfz::args::integer_option(get_value(), &jobs); return true;
+            case 'd': {
+                int64_t at;
+                sfz::args::integer_option(get_value(), &at);
+                dump_at.emplace(at);
+                return true;
+            }
             default: return false;
         }
     };
@@ -215,6 +490,39 @@ void main(int argc, char* const* argv) {
             return callbacks.short_option(pn::rune{'t'}, get_value);
         } else if (opt == "smoke") {
             return callbacks.short_option(pn::rune{'s'}, get_value);
+        } else if (opt == "batch") {
+            return callbacks.short_option(pn::rune{'b'}, get_value);
+        } else if (opt == "jobs") {
+            return callbacks.short_option(pn::rune{'j'}, get_value);
+        } else if (opt == "dump-state") {
+            return callbacks.short_option(pn::rune{'d'}, get_value);
+        } else if (opt == "software") {
+            software = true;
+            return true;
+        } else if (opt == "raster-threads") {
+            sfz::args::integer_option(get_value(), &raster_threads);
+            return true;
+        } else if (opt == "expect") {
+            expect_dir.emplace(get_value().copy());
+            return true;
+        } else if (opt == "keep-going") {
+            keep_going = true;
+            return true;
+        } else if (opt == "tolerance") {
+            sfz::args::integer_option(get_value(), &tolerance);
+            return true;
+        } else if (opt == "text-output") {
+            text_output.emplace(get_value().copy());
+            return true;
+        } else if (opt == "binary-log") {
+            binary_log = true;
+            return true;
+        } else if (opt == "gl-stats") {
+            gl_stats = true;
+            return true;
+        } else if (opt == "memory") {
+            memory = true;
+            return true;
         } else if (opt == "opengl") {
             if (get_value() == "2.0") {
                 gl_version   = {2, 0};
@@ -226,6 +534,30 @@ void main(int argc, char* const* argv) {
                 throw std::runtime_error("invalid OpenGL version");
             }
             return true;
+        } else if (opt == "video") {
+            video_path.emplace(get_value().copy());
+            return true;
+        } else if (opt == "png-level") {
+            sfz::args::integer_option(get_value(), &png_options.level);
+            if ((png_options.level < 0) || (png_options.level > 9)) {
+                throw std::runtime_error("invalid PNG level");
+            }
+            return true;
+        } else if (opt == "png-filter") {
+            if (get_value() == "none") {
+                png_options.filter = PngOptions::Filter::NONE;
+            } else if (get_value() == "sub") {
+                png_options.filter = PngOptions::Filter::SUB;
+            } else if (get_value() == "up") {
+                png_options.filter = PngOptions::Filter::UP;
+            } else if (get_value() == "average") {
+                png_options.filter = PngOptions::Filter::AVERAGE;
+            } else if (get_value() == "paeth") {
+                png_options.filter = PngOptions::Filter::PAETH;
+            } else {
+                throw std::runtime_error("invalid PNG filter");
+            }
+            return true;
         } else if (opt == "help") {
             usage(pn::out, sfz::path::basename(argv[0]), 0);
             return true;
@@ -235,13 +567,39 @@ void main(int argc, char* const* argv) {
     };
 
     args::parse(argc - 1, argv + 1, callbacks);
-    if (!replay_path.has_value()) {
+    if (batch_dir.has_value()) {
+        if (replay_path.has_value()) {
+            throw std::runtime_error("--batch doesn't take a 'replay' argument");
+        } else if (dump_at.has_value() || text || smoke || text_output.has_value() || software ||
+                   video_path.has_value() || expect_dir.has_value()) {
+            throw std::runtime_error(
+                    "--batch can't be used with --dump-state, --text, --smoke, --text-output, "
+                    "--software, --video or --expect");
+        }
+    } else if (!replay_path.has_value()) {
         throw std::runtime_error("missing required argument 'replay'");
     }
+    if (text_output.has_value() && (text || smoke || video_path.has_value())) {
+        throw std::runtime_error("--text-output can't be used with --text, --smoke or --video");
+    } else if (expect_dir.has_value() && (text_output.has_value() || video_path.has_value())) {
+        throw std::runtime_error("--expect can't be used with --text-output or --video");
+    } else if (expect_dir.has_value() && smoke) {
+        throw std::runtime_error("--expect can't be used with --smoke");
+    } else if (video_path.has_value() && (text || smoke)) {
+        throw std::runtime_error("--video can't be used with --text or --smoke");
+    }
 
     if (output_dir.has_value()) {
         sfz::makedirs(*output_dir, 0755);
     }
+    if (text_output.has_value()) {
+        sfz::makedirs(*text_output, 0755);
+    }
+
+    if (batch_dir.has_value()) {
+        play_batch(*batch_dir, jobs, {width, height}, output_dir);
+        return;
+    }
 
     Preferences preferences;
     preferences.play_music_in_game = true;
@@ -249,10 +607,7 @@ void main(int argc, char* const* argv) {
 
     EventScheduler scheduler;
     scheduler.schedule_event(unique_ptr<Event>(new MouseMoveEvent(wall_time(), Point(320, 240))));
-    // TODO(sfiera): add recurring snapshots to OffscreenVideoDriver.
-    for (int64_t i = 1; i < 72000; i += interval) {
-        scheduler.schedule_snapshot(i);
-    }
+    scheduler.schedule_snapshots(1, interval, sfz::nullopt);
 
     unique_ptr<SoundDriver> sound;
     if (!smoke && output_dir.has_value()) {
@@ -263,19 +618,115 @@ void main(int argc, char* const* argv) {
     }
     NullLedger ledger;
 
-    pn::input replay_file{*replay_path, pn::binary};
+    unique_ptr<ExpectedSnapshots> expected;
+    if (expect_dir.has_value()) {
+        expected.reset(new ExpectedSnapshots(*expect_dir, output_dir, keep_going, tolerance));
+    }
+
+    // Memory is reported while the driver still exists, so that its atlas pages are counted.
+    auto report = [memory] {
+        if (memory) {
+            report_memory(pn::err);
+        }
+    };
+
+    // Game ticks are 1/60 s, and there is one video frame per interval.
+    sfz::optional<pn::output> video_file;
+    if (video_path.has_value() && (*video_path != "-")) {
+        video_file.emplace(*video_path, pn::binary);
+    }
+    auto video_output = [&video_file]() -> pn::output_view {
+        if (video_file.has_value()) {
+            return *video_file;
+        }
+        return pn::out;
+    };
+
+    pn::input  replay_file{*replay_path, pn::binary};
+    GameResult game_result = NO_GAME;
     if (smoke) {
         TextVideoDriver video({width, height}, sfz::optional<pn::string>());
-        video.loop(new ReplayMaster(replay_file, output_dir), scheduler);
+        video.set_binary_log(binary_log);
+        video.set_expected(expected.get());
+        video.loop(
+                new ReplayMaster(replay_file, output_dir, dump_at, nullptr, &game_result),
+                scheduler);
+        report();
     } else if (text) {
         TextVideoDriver video({width, height}, output_dir);
-        video.loop(new ReplayMaster(replay_file, output_dir), scheduler);
+        video.set_binary_log(binary_log);
+        video.set_expected(expected.get());
+        video.loop(
+                new ReplayMaster(replay_file, output_dir, dump_at, nullptr, &game_result),
+                scheduler);
+        report();
+    } else if (text_output.has_value()) {
+        // One run draws both the screenshots and the text log.
+        TeeVideoDriver video;
+        if (software) {
+            SoftwareVideoDriver& images =
+                    video.add<SoftwareVideoDriver>(Size{width, height}, 1, output_dir);
+            images.set_png_options(png_options);
+            images.set_raster_threads(raster_threads);
+        } else {
+#ifndef _WIN32
+            video.add<OffscreenVideoDriver>(
+                         Size{width, height}, 1, gl_version, glsl_version, output_dir)
+                    .set_png_options(png_options);
+#endif
+        }
+        video.add<TextVideoDriver>(Size{width, height}, text_output).set_binary_log(binary_log);
+        video.loop(
+                new ReplayMaster(replay_file, output_dir, dump_at, nullptr, &game_result),
+                scheduler);
+        report();
+    } else if (software) {
+        SoftwareVideoDriver video({width, height}, 1, output_dir);
+        video.set_png_options(png_options);
+        video.set_raster_threads(raster_threads);
+        video.set_expected(expected.get());
+        if (video_path.has_value()) {
+            video.set_video_output(video_output(), 60, interval);
+        }
+        video.loop(
+                new ReplayMaster(replay_file, output_dir, dump_at, nullptr, &game_result),
+                scheduler);
+        report();
     } else {
 #ifndef _WIN32
         OffscreenVideoDriver video({width, height}, 1, gl_version, glsl_version, output_dir);
-        video.loop(new ReplayMaster(replay_file, output_dir), scheduler);
+        video.set_png_options(png_options);
+        video.set_expected(expected.get());
+        if (video_path.has_value()) {
+            video.set_video_output(video_output(), 60, interval);
+        }
+        video.loop(
+                new ReplayMaster(replay_file, output_dir, dump_at, nullptr, &game_result),
+                scheduler);
+        report();
+        if (gl_stats) {
+            const OpenGlVideoDriver::Stats& stats  = video.stats();
+            const int64_t                   frames = std::max<int64_t>(stats.frames, 1);
+            pn::err.format(
+                    "{0} frames: {1} draw calls ({2}/frame), {3} buffer uploads ({4}/frame)\n",
+                    stats.frames, stats.draw_calls, stats.draw_calls / frames,
+                    stats.buffer_uploads, stats.buffer_uploads / frames);
+            pn::err.format(
+                    "{0} texture binds ({1}/frame), {2} textures at exit\n", stats.texture_binds,
+                    stats.texture_binds / frames, stats.textures);
+            pn::err.format(
+                    "{0} atlas pages uploaded, {1} evicted\n", stats.page_uploads,
+                    stats.page_evictions);
+            pn::err.format(
+                    "{0} program changes ({1}/frame)\n", stats.program_uses,
+                    stats.program_uses / frames);
+        }
 #endif
     }
+
+    if (expected) {
+        expected->finish();
+    }
 }
 
 }  // namespace
@@ -0,0 +1,370 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include <algorithm>
+#include <cmath>
+#include <pn/output>
+#include <sfz/sfz.hpp>
+
+#include "config/preferences.hpp"
+#include "data/base-object.hpp"
+#include "data/info.hpp"
+#include "data/plugin.hpp"
+#include "data/resource.hpp"
+#include "game/admiral.hpp"
+#include "game/globals.hpp"
+#include "game/space-object.hpp"
+#include "lang/exception.hpp"
+#include "video/text-driver.hpp"
+
+namespace args = sfz::args;
+
+namespace antares {
+namespace {
+
+struct StressParams {
+    pn::string_view name;
+    int             admirals;    // number of sides, all CPU-controlled
+    int             ships;       // initial ships per side
+    int             beams;       // percentage of ships armed with beams, rather than bolts
+    int             actions;     // `create` actions (each followed by a `delay`) per condition
+    int             conditions;  // timed reinforcement conditions, spread over the sides
+};
+
+// From small to extreme. The largest puts 240 initial objects in a table of kMaxSpaceObject
+// (250), so that reinforcements and projectiles run out of slots.
+const StressParams kPresets[] = {
+        {"tiny", 2, 5, 20, 1, 2},       {"small", 2, 20, 25, 2, 8},
+        {"medium", 4, 25, 50, 4, 16},   {"large", 4, 50, 50, 8, 32},
+        {"extreme", 4, 60, 75, 16, 64},
+};
+
+// Hulls are picked from the factory scenario, rather than defined by the plugin, so that the
+// levels exercise the same objects as real play.
+const pn::string_view kRaces[] = {"ish", "gai", "can", "sal", "aud", "uns", "obi", "ele"};
+const pn::string_view kShips[] = {"fighter", "gunship", "cruiser", "carrier", "aslttran"};
+
+const double kPi           = std::acos(-1.0);
+const int    kSideDistance = 4000;  // from the center of the level to the front of each side
+const int    kShipSpacing  = 300;   // between ships in a side's formation
+const int    kRowLength    = 10;    // ships per row of a side's formation
+const int    kFirstWave    = 10;    // seconds until the first reinforcement condition fires
+const int    kWaveInterval = 3;     // seconds between reinforcement conditions
+
+enum class Armament { NONE, BOLT, BEAM };
+
+// A weapon is a beam if the projectile it creates is a ray, and a bolt if it is a bolt.
+Armament armament(const NamedHandle<const BaseObject>& weapon) {
+    load_object(weapon);
+    Armament result = Armament::NONE;
+    for (const Action& a : weapon->activate.action) {
+        if (a.type() != Action::Type::CREATE) {
+            continue;
+        }
+        load_object(a.create.base);
+        if (a.create.base->ray.has_value()) {
+            return Armament::BEAM;
+        } else if (a.create.base->bolt.has_value()) {
+            result = Armament::BOLT;
+        }
+    }
+    return result;
+}
+
+Armament armament(const BaseObject& o) {
+    Armament result = Armament::NONE;
+    for (const auto* w : {&o.weapons.pulse, &o.weapons.beam, &o.weapons.special}) {
+        if (w->has_value()) {
+            result = std::max(result, armament((*w)->base));
+        }
+    }
+    return result;
+}
+
+struct Hulls {
+    std::vector<pn::string> races;
+    std::vector<pn::string> bolts;
+    std::vector<pn::string> beams;
+};
+
+Hulls find_hulls() {
+    Hulls hulls;
+    for (pn::string_view race : kRaces) {
+        if (!Resource::race_exists(race)) {
+            continue;
+        }
+        hulls.races.push_back(race.copy());
+        for (pn::string_view ship : kShips) {
+            pn::string name = pn::format("{0}/{1}", race, ship);
+            if (!Resource::object_exists(name)) {
+                continue;
+            }
+            NamedHandle<const BaseObject> object(name);
+            load_object(object);
+            switch (armament(*object)) {
+                case Armament::NONE: break;
+                case Armament::BOLT: hulls.bolts.push_back(std::move(name)); break;
+                case Armament::BEAM: hulls.beams.push_back(std::move(name)); break;
+            }
+        }
+    }
+    if (hulls.races.empty()) {
+        throw std::runtime_error("no races found in factory scenario");
+    }
+    return hulls;
+}
+
+// Spreads `percent` evenly over a sequence, so that any prefix of it has about the right mix.
+bool pick(int index, int percent) {
+    return ((index + 1) * percent / 100) > (index * percent / 100);
+}
+
+pn::string_view hull(const Hulls& hulls, int index, int percent) {
+    const std::vector<pn::string>& pool = pick(index, percent) ? hulls.beams : hulls.bolts;
+    if (pool.empty()) {
+        throw std::runtime_error(pn::format(
+                                         "no {0} hulls found in factory scenario",
+                                         (&pool == &hulls.beams) ? "beam" : "bolt")
+                                         .c_str());
+    }
+    return pool[index % pool.size()];
+}
+
+void check(const StressParams& p) {
+    if ((p.admirals < 2) || (p.admirals > int(kMaxPlayerNum))) {
+        throw std::runtime_error(
+                pn::format("{0}: admirals must be within [2, {1}]", p.name, int(kMaxPlayerNum))
+                        .c_str());
+    } else if ((p.ships < 1) || ((p.admirals * p.ships) > kMaxSpaceObject)) {
+        throw std::runtime_error(
+                pn::format("{0}: total ships must be within [1, {1}]", p.name, kMaxSpaceObject)
+                        .c_str());
+    } else if ((p.beams < 0) || (p.beams > 100)) {
+        throw std::runtime_error(pn::format("{0}: beams must be a percentage", p.name).c_str());
+    } else if ((p.actions < 0) || (p.conditions < 0)) {
+        throw std::runtime_error(
+                pn::format("{0}: actions and conditions must not be negative", p.name).c_str());
+    }
+}
+
+pn::value stress_level(const StressParams& p, const Hulls& hulls) {
+    pn::array players;
+    for (int i = 0; i < p.admirals; ++i) {
+        players.push_back(pn::map{
+                {"name", pn::format("Side {0}", i + 1)},
+                {"race", hulls.races[i % hulls.races.size()].copy()},
+        });
+    }
+
+    // Each side is a block of rows facing the center, evenly spaced around it.
+    pn::array initials;
+    for (int i = 0; i < p.admirals; ++i) {
+        const double angle = (2 * kPi * i) / p.admirals;
+        const double c = std::cos(angle), s = std::sin(angle);
+        for (int j = 0; j < p.ships; ++j) {
+            const double depth = kSideDistance + (j / kRowLength) * kShipSpacing;
+            const double width = ((j % kRowLength) - (kRowLength - 1) / 2.0) * kShipSpacing;
+            pn::map      initial{
+                    {"base", hull(hulls, j, p.beams).copy()},
+                    {"owner", i},
+                    {"at",
+                     pn::map{
+                             {"x", int64_t(std::lround((depth * c) - (width * s)))},
+                             {"y", int64_t(std::lround((depth * s) + (width * c)))},
+                     }},
+            };
+            if (j == 0) {
+                initial["flagship"] = true;
+            }
+            initials.push_back(std::move(initial));
+        }
+    }
+
+    // Each condition brings reinforcements to the flagship of one side, alternating between
+    // sides, with a delay between each ship.
+    pn::array conditions;
+    for (int i = 0; i < p.conditions; ++i) {
+        pn::array actions;
+        for (int j = 0; j < p.actions; ++j) {
+            actions.push_back(pn::map{
+                    {"type", "create"},
+                    {"base", hull(hulls, (i * p.actions) + j, p.beams).copy()},
+            });
+            actions.push_back(pn::map{{"type", "delay"}, {"duration", "1s"}});
+        }
+        conditions.push_back(pn::map{
+                {"when",
+                 pn::map{
+                         {"type", "time"},
+                         {"op", "ge"},
+                         {"duration", pn::format("{0}s", kFirstWave + (i * kWaveInterval))},
+                 }},
+                {"subject", pn::map{{"flagship", i % p.admirals}}},
+                {"action", std::move(actions)},
+        });
+    }
+
+    return pn::map{
+            {"type", "demo"},
+            {"title", pn::format("Stress: {0}", p.name)},
+            {"players", std::move(players)},
+            {"initials", std::move(initials)},
+            {"conditions", std::move(conditions)},
+    };
+}
+
+void write(pn::string_view path, const pn::value& x) {
+    try {
+        sfz::makedirs(sfz::path::dirname(path), 0755);
+        pn::output out = pn::output{path, pn::text}.check();
+        out.dump(x);
+    } catch (...) {
+        std::throw_with_nested(std::runtime_error(path.copy().c_str()));
+    }
+}
+
+void usage(pn::output_view out, pn::string_view progname, int retcode) {
+    out.format(
+            "usage: {0} [OPTIONS]\n"
+            "\n"
+            "  Generates a plugin of synthetic levels for scaling benchmarks. Hulls are taken\n"
+            "  from the factory scenario, which the plugin falls back to for everything but\n"
+            "  levels. Each level is named after its preset, e.g. levels/large.pn.\n"
+            "\n"
+            "  Without -p or any of the level options, generates every preset:\n"
+            "    tiny, small, medium, large, extreme\n"
+            "\n"
+            "  options:\n"
+            "    -o, --output=OUTPUT  place the plugin in this directory (required)\n"
+            "    -p, --preset=PRESET  generate only this preset, or base a custom level on it\n"
+            "    -n, --name=NAME      name of the custom level (default: custom)\n"
+            "        --admirals=N     number of sides (2 to 4)\n"
+            "        --ships=N        initial ships per side\n"
+            "        --beams=PERCENT  percentage of ships armed with beams, not bolts\n"
+            "        --actions=N      `create` actions (plus `delay`s) per condition\n"
+            "        --conditions=N   timed reinforcement conditions\n"
+            "    -h, --help           display this help screen\n",
+            progname);
+    exit(retcode);
+}
+
+const StressParams& preset(pn::string_view name) {
+    for (const StressParams& p : kPresets) {
+        if (p.name == name) {
+            return p;
+        }
+    }
+    throw std::runtime_error(pn::format("{0}: no such preset", name).c_str());
+}
+
+void main(int argc, char* const* argv) {
+    args::callbacks callbacks;
+
+    callbacks.argument = [](pn::string_view arg) { return false; };
+
+    sfz::optional<pn::string> output_dir;
+    sfz::optional<pn::string> preset_name;
+    pn::string                custom_name = "custom";
+    sfz::optional<int>        admirals, ships, beams, actions, conditions;
+    callbacks.short_option = [&](pn::rune opt, const args::callbacks::get_value_f& get_value) {
+        switch (opt.value()) {
+            case 'o': output_dir.emplace(get_value().copy()); return true;
+            case 'p': preset_name.emplace(get_value().copy()); return true;
+            case 'n': custom_name = get_value().copy(); return true;
+            case 'h': usage(pn::out, sfz::path::basename(argv[0]), 0); return true;
+            default: return false;
+        }
+    };
+    callbacks.long_option = [&](pn::string_view                     opt,
+                                const args::callbacks::get_value_f& get_value) {
+        const struct {
+            pn::string_view     name;
+            sfz::optional<int>* value;
+        } ints[] = {
+                {"admirals", &admirals}, {"ships", &ships},           {"beams", &beams},
+                {"actions", &actions},   {"conditions", &conditions},
+        };
+        for (const auto& i : ints) {
+            if (opt == i.name) {
+                int value;
+                sfz::args::integer_option(get_value(), &value);
+                i.value->emplace(value);
+                return true;
+            }
+        }
+        if (opt == "output") {
+            return callbacks.short_option(pn::rune{'o'}, get_value);
+        } else if (opt == "preset") {
+            return callbacks.short_option(pn::rune{'p'}, get_value);
+        } else if (opt == "name") {
+            return callbacks.short_option(pn::rune{'n'}, get_value);
+        } else if (opt == "help") {
+            return callbacks.short_option(pn::rune{'h'}, get_value);
+        } else {
+            return false;
+        }
+    };
+
+    args::parse(argc - 1, argv + 1, callbacks);
+    if (!output_dir.has_value()) {
+        throw std::runtime_error("missing required option --output");
+    }
+
+    std::vector<StressParams> levels;
+    const bool custom = admirals.has_value() || ships.has_value() || beams.has_value() ||
+                        actions.has_value() || conditions.has_value();
+    if (custom) {
+        StressParams p =
+                preset(preset_name.has_value() ? pn::string_view{*preset_name} : "small");
+        p.name         = custom_name;
+        p.admirals     = admirals.value_or(p.admirals);
+        p.ships        = ships.value_or(p.ships);
+        p.beams        = beams.value_or(p.beams);
+        p.actions      = actions.value_or(p.actions);
+        p.conditions   = conditions.value_or(p.conditions);
+        levels.push_back(p);
+    } else if (preset_name.has_value()) {
+        levels.push_back(preset(*preset_name));
+    } else {
+        levels.assign(std::begin(kPresets), std::end(kPresets));
+    }
+    for (const StressParams& p : levels) {
+        check(p);
+    }
+
+    NullPrefsDriver prefs;
+    TextVideoDriver video({640, 480}, {});
+    init_globals();
+    PluginInit(sfz::nullopt);
+    const Hulls hulls = find_hulls();
+
+    write(pn::format("{0}/info.pn", *output_dir),
+          pn::map{
+                  {"title", "Stress Levels"},
+                  {"format", plug.data->info.format},
+                  {"author", "The Antares Authors"},
+                  {"version", "1"},
+          });
+    for (const StressParams& p : levels) {
+        write(pn::format("{0}/levels/{1}.pn", *output_dir, p.name), stress_level(p, hulls));
+    }
+}
+
+}  // namespace
+}  // namespace antares
+
+int main(int argc, char* const* argv) { return antares::wrap_main(antares::main, argc, argv); }
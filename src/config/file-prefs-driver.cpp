@@ -107,6 +107,7 @@ FilePrefsDriver::FilePrefsDriver(pn::string_view path) : _path(path.copy()) {
     pn::map_cref video = m.get("video").as_map();
     set(_current.fullscreen, video.get("fullscreen"));
     set(_current.window_size, video.get("window"));
+    set(_current.swap_interval, video.get("swap interval"));
 }
 
 void FilePrefsDriver::set(const Preferences& p) {
@@ -136,6 +137,7 @@ void FilePrefsDriver::set(const Preferences& p) {
                               {"width", p.window_size.width},
                               {"height", p.window_size.height},
                       }},
+                     {"swap interval", p.swap_interval},
              }},
     });
 }
@@ -98,8 +98,9 @@ Preferences::Preferences() {
 
     volume = 7;
 
-    fullscreen  = false;
-    window_size = {640, 480};
+    fullscreen    = false;
+    window_size   = {640, 480};
+    swap_interval = 1;
 }
 
 Preferences Preferences::copy() const {
@@ -111,6 +112,7 @@ Preferences Preferences::copy() const {
     copy.volume             = volume;
     copy.fullscreen         = fullscreen;
     copy.window_size        = window_size;
+    copy.swap_interval      = swap_interval;
     return copy;
 }
 
@@ -165,6 +167,12 @@ void PrefsDriver::set_window_size(Size size) {
     set(p);
 }
 
+void PrefsDriver::set_swap_interval(int interval) {
+    Preferences p(get().copy());
+    p.swap_interval = interval;
+    set(p);
+}
+
 NullPrefsDriver::NullPrefsDriver() {}
 
 NullPrefsDriver::NullPrefsDriver(Preferences defaults) : _saved(defaults.copy()) {}
@@ -63,11 +63,17 @@ Level::~Level() {
     }
 }
 
-const Level* Level::get(int number) { return Level::get(plug.chapters[number]); }
+const Level* Level::get(int number) {
+    auto it = plug.data->chapters.find(number);
+    if (it == plug.data->chapters.end()) {
+        return nullptr;
+    }
+    return Level::get(it->second);
+}
 
 const Level* Level::get(pn::string_view name) {
-    auto it = plug.levels.find(name.copy());
-    if (it == plug.levels.end()) {
+    auto it = plug.data->levels.find(name.copy());
+    if (it == plug.data->levels.end()) {
         return nullptr;
     } else {
         return &it->second;
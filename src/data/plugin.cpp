@@ -19,6 +19,8 @@
 #include "data/plugin.hpp"
 
 #include <algorithm>
+#include <memory>
+#include <mutex>
 #include <pn/output>
 #include <sfz/sfz.hpp>
 #include <zipxx/zipxx.hpp>
@@ -49,27 +51,29 @@ static constexpr const char kStarmapPicture[] = "starmap";
 
 ANTARES_GLOBAL ScenarioGlobals plug;
 
-static void read_all_levels() {
-    plug.levels.clear();
-    plug.chapters.clear();
+static void read_all_levels(ScenarioData* data) {
+    data->levels.clear();
+    data->chapters.clear();
     for (pn::string_view name : Resource::list_levels()) {
-        auto it = plug.levels.emplace(name.copy(), Resource::level(name)).first;
+        auto it = data->levels.emplace(name.copy(), Resource::level(name)).first;
         if (it->second.base.chapter.has_value()) {
             auto chapter = *it->second.base.chapter;
-            if (plug.chapters.find(chapter) != plug.chapters.end()) {
+            if (data->chapters.find(chapter) != data->chapters.end()) {
                 throw std::runtime_error(pn::format(
                                                  "duplicate chapter {} in levels {} and {}",
-                                                 chapter, plug.chapters[chapter], name)
+                                                 chapter, data->chapters[chapter], name)
                                                  .c_str());
             }
-            plug.chapters[chapter] = name.copy();
+            data->chapters[chapter] = name.copy();
         }
     }
 }
 
-void PluginInit(sfz::optional<pn::string_view> path) {
+void PluginInit(sfz::optional<pn::string_view> path, std::shared_ptr<ScenarioData> data) {
     plug.dir = sfz::nullopt;
     plug.zip = nullptr;
+    plug.objects.clear();
+    plug.races.clear();
     if (path.has_value()) {
         if (path::isdir(*path)) {
             plug.dir.emplace(path->copy());
@@ -78,11 +82,15 @@ void PluginInit(sfz::optional<pn::string_view> path) {
         }
     }
 
-    plug.info = Resource::info();
+    const bool parse = !data;
+    if (parse) {
+        data       = std::make_shared<ScenarioData>();
+        data->info = Resource::info();
+    }
     try {
-        if (plug.info.format != kPluginFormat) {
+        if (data->info.format != kPluginFormat) {
             throw std::runtime_error(
-                    pn::format("unknown plugin format {0}", plug.info.format).c_str());
+                    pn::format("unknown plugin format {0}", data->info.format).c_str());
         }
         plug.splash  = Resource::texture(kSplashPicture);
         plug.starmap = Resource::texture(kStarmapPicture);
@@ -90,21 +98,40 @@ void PluginInit(sfz::optional<pn::string_view> path) {
         std::throw_with_nested(std::runtime_error("info.pn"));
     }
 
-    read_all_levels();
+    if (parse) {
+        read_all_levels(data.get());
+    }
+    plug.data = std::move(data);
+}
+
+// Finds `name` in `cache`, or parses it with `load` and adds it. Parsing happens outside the lock;
+// if another thread adds the same entry meanwhile, its copy wins and this one is discarded.
+template <typename T, typename Load>
+static T* cached(std::map<pn::string, T>& cache, pn::string_view name, Load load) {
+    {
+        std::lock_guard<std::mutex> lock(plug.data->mutex);
+        auto                        it = cache.find(name.copy());
+        if (it != cache.end()) {
+            return &it->second;
+        }
+    }
+    T                           value = load(name);
+    std::lock_guard<std::mutex> lock(plug.data->mutex);
+    return &cache.emplace(name.copy(), std::move(value)).first->second;
 }
 
 void load_race(const NamedHandle<const Race>& r) {
     if (plug.races.find(r.name().copy()) != plug.races.end()) {
         return;  // already loaded.
     }
-    plug.races.emplace(r.name().copy(), Resource::race(r.name()));
+    plug.races.emplace(r.name().copy(), cached(plug.data->races, r.name(), Resource::race));
 }
 
 void load_object(const NamedHandle<const BaseObject>& o) {
     if (plug.objects.find(o.name().copy()) != plug.objects.end()) {
         return;  // already loaded.
     }
-    plug.objects.emplace(o.name().copy(), Resource::object(o.name()));
+    plug.objects.emplace(o.name().copy(), cached(plug.data->objects, o.name(), Resource::object));
 }
 
 }  // namespace antares
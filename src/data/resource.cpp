@@ -329,6 +329,10 @@ bool Resource::object_exists(pn::string_view name) {
     return resource_exists(pn::format("objects/{0}.pn", name));
 }
 
+bool Resource::race_exists(pn::string_view name) {
+    return resource_exists(pn::format("races/{0}.pn", name));
+}
+
 FontData Resource::font(pn::string_view name) {
     pn::string path = pn::format("fonts/{0}.pn", name);
     try {
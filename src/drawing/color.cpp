@@ -19,6 +19,8 @@
 #include "drawing/color.hpp"
 
 #include <stdint.h>
+#include <algorithm>
+#include <cmath>
 #include <pn/output>
 
 #include "lang/casts.hpp"
@@ -150,4 +152,39 @@ RgbColor GetRGBTranslateColorShade(Hue hue, uint8_t shade) {
 
 RgbColor GetRGBTranslateColor(uint8_t color) { return RgbColor::at(color); }
 
+namespace {
+
+struct SrgbTables {
+    float decode[256];  // linear value of each Apple RGB level
+    float encode[255];  // linear value at which each sRGB level after 0 begins
+
+    SrgbTables() {
+        for (int i = 0; i < 256; ++i) {
+            decode[i] = pow(i / 255.0, 1.8);
+        }
+        for (int i = 0; i < 255; ++i) {
+            const double e = (i + 0.5) / 255.0;
+            encode[i]      = (e <= 0.040449936) ? (e / 12.92) : pow((e + 0.055) / 1.055, 2.4);
+        }
+    }
+};
+
+}  // namespace
+
+RgbColor apple_rgb_to_srgb(const RgbColor& color) {
+    static const SrgbTables t;
+    static const float      m[3][3] = {
+            {1.06870538834699f, 0.024110476735f, 0.00173499822713f},
+            {-0.07859532843279f, 0.96007030899244f, 0.02974755969275f},
+            {0.00988984558395f, 0.01581936633364f, 0.96851741859153f},
+    };
+    const float r = t.decode[color.red], g = t.decode[color.green], b = t.decode[color.blue];
+    uint8_t     out[3];
+    for (int i = 0; i < 3; ++i) {
+        const float v = (r * m[0][i]) + (g * m[1][i]) + (b * m[2][i]);
+        out[i]        = std::upper_bound(t.encode, t.encode + 255, v) - t.encode;
+    }
+    return rgba(out[0], out[1], out[2], color.alpha);
+}
+
 }  // namespace antares
@@ -112,7 +112,19 @@ ArrayPixMap read_png(pn::input_view in) {
     return pix;
 }
 
-void PixMap::encode(pn::output_view out) {
+static int png_filters(PngOptions::Filter filter) {
+    switch (filter) {
+        case PngOptions::Filter::DEFAULT: return PNG_ALL_FILTERS;
+        case PngOptions::Filter::NONE: return PNG_FILTER_NONE;
+        case PngOptions::Filter::SUB: return PNG_FILTER_SUB;
+        case PngOptions::Filter::UP: return PNG_FILTER_UP;
+        case PngOptions::Filter::AVERAGE: return PNG_FILTER_AVG;
+        case PngOptions::Filter::PAETH: return PNG_FILTER_PAETH;
+    }
+    return PNG_ALL_FILTERS;
+}
+
+void PixMap::encode(pn::output_view out, const PngOptions& options) {
     png_struct* png = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
     if (!png) {
         throw std::runtime_error("couldn't create png_struct");
@@ -132,6 +144,12 @@ void PixMap::encode(pn::output_view out) {
     png_set_write_fn(png, out.c_obj(), png_write_data, png_flush_data);
     png_set_IHDR(png, info, size().width, size().height, 8, PNG_COLOR_TYPE_RGBA, 0, 0, 0);
     png_set_swap_alpha(png);
+    if (options.level >= 0) {
+        png_set_compression_level(png, options.level);
+    }
+    if (options.filter != PngOptions::Filter::DEFAULT) {
+        png_set_filter(png, PNG_FILTER_TYPE_BASE, png_filters(options.filter));
+    }
 
     png_write_info(png, info);
     for (int i = 0; i < size().height; ++i) {
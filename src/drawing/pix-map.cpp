@@ -138,4 +138,41 @@ RgbColor* PixMap::View::mutable_bytes() {
 
 PixMap::View PixMap::view(const Rect& bounds) { return View(this, bounds); }
 
+void tint_overlay(PixMap* pix, const PixMap& overlay, Hue hue) {
+    if (pix->size() != overlay.size()) {
+        throw std::runtime_error("Mismatch in PixMap sizes");
+    }
+    for (int y = 0; y < pix->size().height; ++y) {
+        for (int x = 0; x < pix->size().width; ++x) {
+            RgbColor over  = overlay.get(x, y);
+            uint8_t  value = over.red;
+            uint8_t  frac  = over.alpha;
+            over           = RgbColor::tint(hue, value);
+            RgbColor under = pix->get(x, y);
+            RgbColor composite;
+            composite.red   = ((over.red * frac) + (under.red * (255 - frac))) / 255;
+            composite.green = ((over.green * frac) + (under.green * (255 - frac))) / 255;
+            composite.blue  = ((over.blue * frac) + (under.blue * (255 - frac))) / 255;
+            composite.alpha = under.alpha;
+            pix->set(x, y, composite);
+        }
+    }
+}
+
+void apple_rgb_to_srgb(PixMap* pix) {
+    RgbColor from = RgbColor::clear(), to = RgbColor::clear();
+    for (int y = 0; y < pix->size().height; ++y) {
+        RgbColor* row = pix->mutable_row(y);
+        for (int x = 0; x < pix->size().width; ++x) {
+            if (row[x].alpha == 0) {
+                continue;
+            } else if (row[x] != from) {
+                from = row[x];
+                to   = apple_rgb_to_srgb(from);
+            }
+            row[x] = to;
+        }
+    }
+}
+
 }  // namespace antares
@@ -18,6 +18,8 @@
 
 #include "drawing/pix-table.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <pn/array>
 #include <pn/map>
 #include <pn/output>
@@ -35,78 +37,175 @@ using std::vector;
 
 namespace antares {
 
-NatePixTable::NatePixTable(pn::string_view name, Hue hue) {
-    SpriteData  data    = Resource::sprite_data(name);
-    ArrayPixMap image   = Resource::sprite_image(name);
-    ArrayPixMap overlay = Resource::sprite_overlay(name);
+namespace {
 
-    if (image.size() != overlay.size()) {
-        throw std::runtime_error("size mismatch between image and overlay");
-    }
+// Atlas pages are no larger than this in either dimension, unless a single frame is.
+const int kMaxAtlasSize = 2048;
+
+}  // namespace
+
+// Packs frames into as few atlas pages as possible, so that drawing a sprite's frames doesn't
+// switch textures. Frames are placed in rows, tallest first, each with its own 1-pixel clear
+// border. Only the layout is computed here; images are decoded by decode().
+std::shared_ptr<NatePixTable::Sheet> NatePixTable::load(pn::string_view name) {
+    SpriteData data = Resource::sprite_data(name);
+
+    std::shared_ptr<Sheet> sheet = std::make_shared<Sheet>();
+    sheet->name                  = name.copy();
+    std::vector<int> order;
+    int64_t          area  = 0;
+    int              width = 0;
     for (SpriteData::Frame frame : data.frames) {
-        const int i = _frames.size();
-        Rect      sprite{frame.left, frame.top, frame.right, frame.bottom};
-        Rect      bounds = sprite;
+        Rect sprite{frame.left, frame.top, frame.right, frame.bottom};
+        Rect bounds = sprite;
         bounds.offset(-frame.cx, -frame.cy);
-        if (hue == Hue::GRAY) {
-            _frames.emplace_back(bounds, image.view(sprite), name, i);
-        } else {
-            _frames.emplace_back(bounds, image.view(sprite), name, i, overlay.view(sprite), hue);
+        order.push_back(sheet->frames.size());
+        sheet->frames.push_back(Sheet::Frame{bounds, sprite, 0, Rect{}});
+        area += (sprite.width() + 2) * (sprite.height() + 2);
+        width = std::max(width, sprite.width() + 2);
+    }
+    std::stable_sort(order.begin(), order.end(), [&sheet](int a, int b) {
+        return sheet->frames[a].source.height() > sheet->frames[b].source.height();
+    });
+    const int side = std::ceil(std::sqrt(double(area)));
+    width          = std::max(width, std::min(kMaxAtlasSize, side));
+
+    auto begin = order.begin();
+    while (begin != order.end()) {
+        // Lay out one page's worth of frames.
+        Point at       = {0, 0};
+        int   row_size = 0;
+        auto  end      = begin;
+        for (; end != order.end(); ++end) {
+            Sheet::Frame& frame  = sheet->frames[*end];
+            const Rect&   sprite = frame.source;
+            if ((at.h + sprite.width() + 2) > width) {
+                at       = {0, at.v + row_size};
+                row_size = 0;
+            }
+            if ((end != begin) && ((at.v + sprite.height() + 2) > kMaxAtlasSize)) {
+                break;
+            }
+            frame.page   = sheet->pages.size();
+            frame.region = Rect(Point{at.h + 1, at.v + 1}, sprite.size());
+            at.h += sprite.width() + 2;
+            row_size = std::max(row_size, sprite.height() + 2);
         }
+        sheet->pages.push_back(Sheet::Page{Size{width, at.v + row_size}, nullptr, false});
+        begin = end;
     }
+    return sheet;
 }
 
-NatePixTable::~NatePixTable() {}
+void NatePixTable::Sheet::decode() const {
+    if (image) {
+        return;
+    }
+    std::unique_ptr<ArrayPixMap> sprite_image(new ArrayPixMap(Resource::sprite_image(name)));
+    std::unique_ptr<ArrayPixMap> sprite_overlay(new ArrayPixMap(Resource::sprite_overlay(name)));
+    if (sprite_image->size() != sprite_overlay->size()) {
+        throw std::runtime_error("size mismatch between image and overlay");
+    }
+    image   = std::move(sprite_image);
+    overlay = std::move(sprite_overlay);
+}
 
-const NatePixTable::Frame& NatePixTable::at(size_t index) const { return _frames[index]; }
+void NatePixTable::Sheet::load_page(
+        int page, const Rect& region, PixMap* page_image, PixMap* page_overlay) const {
+    decode();
+    page_image->fill(RgbColor::clear());
+    page_overlay->fill(RgbColor::clear());
+    for (const Frame& frame : frames) {
+        if ((frame.page != page) || !frame.region.intersects(region)) {
+            continue;
+        }
+        Rect dest = frame.region;
+        dest.clip_to(region);
+        Rect source = dest;
+        source.offset(frame.source.left - frame.region.left, frame.source.top - frame.region.top);
+        dest.offset(-region.left, -region.top);
+        page_image->view(dest).copy(image->view(source));
+        page_overlay->view(dest).copy(overlay->view(source));
+    }
 
-size_t NatePixTable::size() const { return _size; }
+    const bool whole_page =
+            (region.left == 0) && (region.top == 0) && (region.size() == pages[page].size);
+    if (!whole_page) {
+        return;
+    }
+    // Keep the decoded images while a page that has been drawn is yet to be loaded.
+    pages[page].resident = true;
+    for (const Page& p : pages) {
+        if (p.atlas && !p.resident) {
+            return;
+        }
+    }
+    image.reset();
+    overlay.reset();
+}
 
-NatePixTable::Frame::Frame(
-        Rect bounds, const PixMap& image, pn::string_view name, int frame, const PixMap& overlay,
-        Hue hue)
-        : _bounds(bounds), _pix_map(bounds.width(), bounds.height()) {
-    load_image(image);
-    load_overlay(overlay, hue);
-    build(name, frame);
+int64_t NatePixTable::Sheet::bytes() const {
+    if (!image) {
+        return 0;
+    }
+    const Size size = image->size();
+    return int64_t{8} * size.width * size.height;  // image and overlay
 }
 
-NatePixTable::Frame::Frame(Rect bounds, const PixMap& image, pn::string_view name, int frame)
-        : _bounds(bounds), _pix_map(bounds.width(), bounds.height()) {
-    load_image(image);
-    build(name, frame);
+NatePixTable::NatePixTable(pn::string_view name, Hue hue) : NatePixTable(load(name), hue) {}
+
+NatePixTable::NatePixTable(std::shared_ptr<Sheet> sheet, Hue hue) : _sheet(std::move(sheet)) {
+    for (int i : range<int>(_sheet->frames.size())) {
+        _frames.emplace_back(*_sheet, i, hue);
+    }
 }
 
+NatePixTable::~NatePixTable() {}
+
+const NatePixTable::Frame& NatePixTable::at(size_t index) const { return _frames[index]; }
+
+size_t NatePixTable::size() const { return _frames.size(); }
+
+NatePixTable::Frame::Frame(Sheet& sheet, int index, Hue hue)
+        : _sheet(&sheet), _index(index), _hue(hue) {}
+
 NatePixTable::Frame::~Frame() {}
 
-void NatePixTable::Frame::load_image(const PixMap& pix) { _pix_map.copy(pix); }
-
-void NatePixTable::Frame::load_overlay(const PixMap& pix, Hue hue) {
-    for (auto x : range(width())) {
-        for (auto y : range(height())) {
-            RgbColor over  = pix.get(x, y);
-            uint8_t  value = over.red;
-            uint8_t  frac  = over.alpha;
-            over           = RgbColor::tint(hue, value);
-            RgbColor under = _pix_map.get(x, y);
-            RgbColor composite;
-            composite.red   = ((over.red * frac) + (under.red * (255 - frac))) / 255;
-            composite.green = ((over.green * frac) + (under.green * (255 - frac))) / 255;
-            composite.blue  = ((over.blue * frac) + (under.blue * (255 - frac))) / 255;
-            composite.alpha = under.alpha;
-            _pix_map.set(x, y, composite);
+uint16_t       NatePixTable::Frame::width() const { return entry().bounds.width(); }
+uint16_t       NatePixTable::Frame::height() const { return entry().bounds.height(); }
+
+Point NatePixTable::Frame::center() const {
+    return {-entry().bounds.left, -entry().bounds.top};
+}
+
+// Most frames of most sprites are never drawn in a given level, such as the rotations of ships
+// that stay still, so textures are only created when first needed. A page's atlas is likewise
+// created when the first of its frames is drawn.
+const Texture& NatePixTable::Frame::texture() const {
+    if (!_texture) {
+        Sheet::Page& page = _sheet->pages[entry().page];
+        if (!page.atlas) {
+            const Sheet* sheet = _sheet;
+            const int    index = entry().page;
+            page.atlas         = sys.video->atlas(
+                    page.size, [sheet, index](const Rect& region, PixMap* image, PixMap* overlay) {
+                        sheet->load_page(index, region, image, overlay);
+                    });
         }
+        const pn::string name = pn::format("/sprites/{0}%{1}", _sheet->name, _index);
+        _texture              = page.atlas.texture(name, entry().region, _hue);
     }
+    return _texture;
 }
 
-uint16_t       NatePixTable::Frame::width() const { return _bounds.width(); }
-uint16_t       NatePixTable::Frame::height() const { return _bounds.height(); }
-Point          NatePixTable::Frame::center() const { return {-_bounds.left, -_bounds.top}; }
-const PixMap&  NatePixTable::Frame::pix_map() const { return _pix_map; }
-const Texture& NatePixTable::Frame::texture() const { return _texture; }
-
-void NatePixTable::Frame::build(pn::string_view name, int frame) {
-    _texture = sys.video->texture(pn::format("/sprites/{0}%{1}", name, frame), _pix_map, 1);
+ArrayPixMap NatePixTable::Frame::pix_map() const {
+    _sheet->decode();
+    ArrayPixMap pix(entry().source.size());
+    pix.copy(_sheet->image->view(entry().source));
+    if (_hue != Hue::GRAY) {
+        tint_overlay(&pix, _sheet->overlay->view(entry().source), _hue);
+    }
+    return pix;
 }
 
 }  // namespace antares
@@ -0,0 +1,109 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "drawing/png-writer.hpp"
+
+#include <algorithm>
+#include <pn/data>
+#include <pn/output>
+#include <sfz/sfz.hpp>
+
+namespace antares {
+
+PngWriter::PngWriter(int threads, int capacity, PngOptions options)
+        : _options(options), _capacity(std::max(capacity, 1)) {
+    for (int i = 0; i < std::max(threads, 1); ++i) {
+        _threads.emplace_back([this] { work(); });
+    }
+}
+
+PngWriter::~PngWriter() {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _stopping = true;
+        _changed.notify_all();
+    }
+    for (std::thread& thread : _threads) {
+        thread.join();
+    }
+}
+
+void PngWriter::write(pn::string_view path, ArrayPixMap pix) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _changed.wait(lock, [this] { return (_queued - _written) < _capacity; });
+    check();
+    _queue.push_back(Job{_queued++, path.copy(), std::move(pix)});
+    _changed.notify_all();
+}
+
+void PngWriter::finish() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _changed.wait(lock, [this] { return _written == _queued; });
+    check();
+}
+
+void PngWriter::check() {
+    if (_error) {
+        std::exception_ptr error = _error;
+        _error                   = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void PngWriter::work() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _changed.wait(lock, [this] { return _stopping || !_queue.empty(); });
+        if (_queue.empty()) {
+            return;
+        }
+        Job job = std::move(_queue.front());
+        _queue.pop_front();
+        lock.unlock();
+
+        std::exception_ptr error;
+        pn::data           png;
+        try {
+            job.pix.encode(png.output(), _options);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        // Only the job whose turn it is writes, so it needn't hold the lock while it does.
+        lock.lock();
+        _changed.wait(lock, [this, &job] { return _written == job.sequence; });
+        lock.unlock();
+        if (!error) {
+            try {
+                sfz::makedirs(sfz::path::dirname(job.path), 0755);
+                pn::output out{job.path, pn::binary};
+                out.write(png);
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+
+        lock.lock();
+        if (error && !_error) {
+            _error = error;
+        }
+        ++_written;
+        _changed.notify_all();
+    }
+}
+
+}  // namespace antares
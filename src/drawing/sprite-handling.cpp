@@ -18,9 +18,12 @@
 
 #include "drawing/sprite-handling.hpp"
 
+#include <algorithm>
 #include <numeric>
 #include <sfz/sfz.hpp>
+#include <vector>
 
+#include "data/plugin.hpp"
 #include "data/resource.hpp"
 #include "drawing/color.hpp"
 #include "drawing/pix-table.hpp"
@@ -39,36 +42,56 @@ using std::unique_ptr;
 
 namespace antares {
 
-static void draw_tiny_square(const Rect& rect, const RgbColor& color) {
-    Rects().fill(rect, color);
-}
+namespace {
 
-static void draw_tiny_triangle(const Rect& rect, const RgbColor& color) {
-    sys.video->draw_triangle(rect, color);
-}
+// The size of decoded sprite sheets that Pix keeps when they are not in use.
+const int64_t kSheetCacheBytes = 64 << 20;
 
-static void draw_tiny_diamond(const Rect& rect, const RgbColor& color) {
-    sys.video->draw_diamond(rect, color);
+}  // namespace
+
+static bool tiny_shape(const BaseObject::Icon& icon, IconInstance::Shape* shape) {
+    if (icon.size <= 0) {
+        return false;
+    }
+    switch (icon.shape) {
+        case BaseObject::Icon::Shape::TRIANGLE:
+            *shape = IconInstance::TRIANGLE;
+            return true;
+        case BaseObject::Icon::Shape::SQUARE:
+            *shape = IconInstance::SQUARE;
+            return true;
+        case BaseObject::Icon::Shape::PLUS:
+            *shape = IconInstance::PLUS;
+            return true;
+        case BaseObject::Icon::Shape::DIAMOND:
+            *shape = IconInstance::DIAMOND;
+            return true;
+        default: return false;
+    }
 }
 
-static void draw_tiny_plus(const Rect& rect, const RgbColor& color) {
-    sys.video->draw_plus(rect, color);
+ANTARES_GLOBAL Scale gAbsoluteScale = MIN_SCALE;
+
+// Sprites added and not yet removed, by layer, in slot order. draw_sprites() walks these instead
+// of every slot.
+static ANTARES_GLOBAL std::vector<Handle<Sprite>> sprite_layers[4];
+
+static std::vector<Handle<Sprite>>& layer_list(BaseObject::Layer layer) {
+    return sprite_layers[static_cast<int>(layer)];
 }
 
-static draw_tiny_t draw_tiny_function(BaseObject::Icon::Shape shape, int size) {
-    if (size <= 0) {
-        return NULL;
-    }
-    switch (shape) {
-        case BaseObject::Icon::Shape::TRIANGLE: return draw_tiny_triangle;
-        case BaseObject::Icon::Shape::SQUARE: return draw_tiny_square;
-        case BaseObject::Icon::Shape::PLUS: return draw_tiny_plus;
-        case BaseObject::Icon::Shape::DIAMOND: return draw_tiny_diamond;
-        default: return NULL;
-    }
+static void insert_sprite(Handle<Sprite> sprite) {
+    std::vector<Handle<Sprite>>& list = layer_list(sprite->whichLayer);
+    auto it = std::lower_bound(
+            list.begin(), list.end(), sprite,
+            [](Handle<Sprite> x, Handle<Sprite> y) { return x.number() < y.number(); });
+    list.insert(it, sprite);
 }
 
-Scale ANTARES_GLOBAL gAbsoluteScale = MIN_SCALE;
+static void erase_sprite(Handle<Sprite> sprite) {
+    std::vector<Handle<Sprite>>& list = layer_list(sprite->whichLayer);
+    list.erase(std::remove(list.begin(), list.end(), sprite), list.end());
+}
 
 void SpriteHandlingInit() {
     g.sprites.reset(new Sprite[Sprite::size]);
@@ -93,17 +116,23 @@ Sprite::Sprite()
           styleData(0),
           whichLayer(BaseObject::Layer::NONE),
           killMe(false),
-          draw_tiny(NULL) {}
+          draw_tiny(false),
+          tiny_shape(IconInstance::SQUARE) {}
 
 void ResetAllSprites() {
     for (auto sprite : Sprite::all()) {
         *sprite = Sprite();
     }
+    for (auto& list : sprite_layers) {
+        list.clear();
+    }
 }
 
 void Pix::reset() {
     _pix.clear();
-    _cursor.reset(new NatePixTable("gui/cursor", Hue::GRAY));
+    _cursor.reset();
+    evict();
+    _cursor.reset(new NatePixTable(sheet("gui/cursor"), Hue::GRAY));
 }
 
 NatePixTable* Pix::add(pn::string_view name, Hue hue) {
@@ -112,10 +141,54 @@ NatePixTable* Pix::add(pn::string_view name, Hue hue) {
         return result;
     }
 
-    auto it = _pix.emplace(std::make_pair(name.copy(), hue), NatePixTable(name, hue)).first;
+    auto it = _pix.emplace(std::make_pair(name.copy(), hue), NatePixTable(sheet(name), hue)).first;
     return &it->second;
 }
 
+std::shared_ptr<NatePixTable::Sheet> Pix::sheet(pn::string_view name) {
+    // Sprites are looked up in the plugin before the factory scenario, so the same name may refer
+    // to different images in different plugins.
+    pn::string plugin = plug.data ? plug.data->info.identifier.hash.copy() : pn::string{};
+    auto       key    = std::make_pair(std::move(plugin), name.copy());
+    auto       it     = _sheets.find(key);
+    if (it != _sheets.end()) {
+        it->second.last_use = ++_uses;
+        return it->second.sheet;
+    }
+
+    std::shared_ptr<NatePixTable::Sheet> loaded = NatePixTable::load(name);
+    _sheets.emplace(std::move(key), CachedSheet{loaded, ++_uses});
+    evict();
+    return loaded;
+}
+
+int64_t Pix::sheet_bytes() const {
+    int64_t bytes = 0;
+    for (const auto& kv : _sheets) {
+        bytes += kv.second.sheet->bytes();
+    }
+    return bytes;
+}
+
+void Pix::evict() {
+    int64_t bytes = sheet_bytes();
+    while (bytes > kSheetCacheBytes) {
+        auto lru = _sheets.end();
+        for (auto it = _sheets.begin(); it != _sheets.end(); ++it) {
+            if (!it->second.sheet.unique()) {
+                continue;  // in use by a table.
+            } else if ((lru == _sheets.end()) || (it->second.last_use < lru->second.last_use)) {
+                lru = it;
+            }
+        }
+        if (lru == _sheets.end()) {
+            break;
+        }
+        bytes -= lru->second.sheet->bytes();
+        _sheets.erase(lru);
+    }
+}
+
 NatePixTable* Pix::get(pn::string_view id, Hue hue) {
     auto it = _pix.find({id.copy(), hue});
     if (it != _pix.end()) {
@@ -139,11 +212,12 @@ Handle<Sprite> AddSprite(
             sprite->whichLayer = layer;
             sprite->icon = icon.value_or(BaseObject::Icon{BaseObject::Icon::Shape::SQUARE, 0});
             sprite->tinyColor  = {tiny_hue, tiny_shade};
-            sprite->draw_tiny  = draw_tiny_function(sprite->icon.shape, sprite->icon.size);
+            sprite->draw_tiny  = tiny_shape(sprite->icon, &sprite->tiny_shape);
             sprite->killMe     = false;
             sprite->style      = spriteNormal;
             sprite->styleColor = RgbColor::white();
             sprite->styleData  = 0;
+            insert_sprite(sprite);
 
             return sprite;
         }
@@ -153,10 +227,19 @@ Handle<Sprite> AddSprite(
 }
 
 void RemoveSprite(Handle<Sprite> sprite) {
+    if (sprite->table != NULL) {
+        erase_sprite(sprite);
+    }
     sprite->killMe = false;
     sprite->table  = NULL;
 }
 
+void SetSpriteLayer(Handle<Sprite> sprite, BaseObject::Layer layer) {
+    erase_sprite(sprite);
+    sprite->whichLayer = layer;
+    insert_sprite(sprite);
+}
+
 Rect scale_sprite_rect(const NatePixTable::Frame& frame, Point where, Scale scale) {
     return Rect{
             Point{where.h - scale_by(frame.center().h, scale),
@@ -167,43 +250,51 @@ Rect scale_sprite_rect(const NatePixTable::Frame& frame, Point where, Scale scal
 
 void draw_sprites() {
     if (gAbsoluteScale >= kBlipThreshhold) {
+        std::vector<SpriteInstance> instances;
         for (BaseObject::Layer layer :
              {BaseObject::Layer::BASES, BaseObject::Layer::SHIPS, BaseObject::Layer::SHOTS}) {
-            for (auto aSprite : Sprite::all()) {
-                if ((aSprite->table != NULL) && !aSprite->killMe &&
-                    (aSprite->whichLayer == layer)) {
-                    Scale trueScale                  = scale_by(aSprite->scale, gAbsoluteScale);
-                    const NatePixTable::Frame& frame = aSprite->table->at(aSprite->whichShape);
-
-                    Rect draw_rect = scale_sprite_rect(frame, aSprite->where, trueScale);
-
-                    switch (aSprite->style) {
-                        case spriteNormal: frame.texture().draw(draw_rect); break;
-
-                        case spriteColor:
-                            Randomize(63);
-                            frame.texture().draw_static(
-                                    draw_rect, aSprite->styleColor, aSprite->styleData);
-                            break;
-                    }
+            instances.clear();
+            for (Handle<Sprite> aSprite : layer_list(layer)) {
+                if (aSprite->killMe) {
+                    continue;
+                }
+                Scale trueScale                  = scale_by(aSprite->scale, gAbsoluteScale);
+                const NatePixTable::Frame& frame = aSprite->table->at(aSprite->whichShape);
+
+                SpriteInstance instance = {
+                        &frame.texture(), scale_sprite_rect(frame, aSprite->where, trueScale),
+                        false, RgbColor::white(), 0};
+                switch (aSprite->style) {
+                    case spriteNormal: break;
+
+                    case spriteColor:
+                        Randomize(63);
+                        instance.is_static = true;
+                        instance.color     = aSprite->styleColor;
+                        instance.frac      = aSprite->styleData;
+                        break;
                 }
+                instances.push_back(instance);
             }
+            sys.video->draw_sprites(instances);
         }
     } else {
+        std::vector<IconInstance> icons;
         for (BaseObject::Layer layer :
              {BaseObject::Layer::BASES, BaseObject::Layer::SHIPS, BaseObject::Layer::SHOTS}) {
-            for (auto aSprite : Sprite::all()) {
+            for (Handle<Sprite> aSprite : layer_list(layer)) {
                 int tinySize = aSprite->icon.size;
-                if ((aSprite->table != NULL) && !aSprite->killMe && tinySize &&
-                    (aSprite->draw_tiny != NULL) && (aSprite->whichLayer == layer)) {
+                if (!aSprite->killMe && tinySize && aSprite->draw_tiny) {
                     Rect tiny_rect(-tinySize, -tinySize, tinySize, tinySize);
                     tiny_rect.offset(aSprite->where.h, aSprite->where.v);
-                    aSprite->draw_tiny(
-                            tiny_rect, GetRGBTranslateColorShade(
-                                               aSprite->tinyColor.hue, aSprite->tinyColor.shade));
+                    icons.push_back(IconInstance{
+                            aSprite->tiny_shape, tiny_rect,
+                            GetRGBTranslateColorShade(
+                                    aSprite->tinyColor.hue, aSprite->tinyColor.shade)});
                 }
             }
         }
+        sys.video->draw_icons(icons);
     }
 }
 
@@ -0,0 +1,108 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "drawing/y4m-writer.hpp"
+
+#include <algorithm>
+#include <pn/data>
+#include <stdexcept>
+
+namespace antares {
+
+namespace {
+
+// Fixed-point BT.601 at limited range, in units of 1/256. The loops below are plain integer
+// arithmetic over whole rows, without branches or calls, so that the compiler vectorizes them.
+
+void luma_row(const RgbColor* rgb, int width, uint8_t* y) {
+    for (int x = 0; x < width; ++x) {
+        const int r = rgb[x].red, g = rgb[x].green, b = rgb[x].blue;
+        y[x]        = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+    }
+}
+
+// Converts the 2x2 blocks that start in rows `top` and `bottom` (which are the same row if the
+// height is odd); an odd last column counts twice.
+void chroma_row(
+        const RgbColor* top, const RgbColor* bottom, int width, uint8_t* cb, uint8_t* cr) {
+    const int half = width / 2;
+    for (int x = 0; x < half; ++x) {
+        const RgbColor* t = top + (2 * x);
+        const RgbColor* b = bottom + (2 * x);
+        const int       r = t[0].red + t[1].red + b[0].red + b[1].red;
+        const int       g = t[0].green + t[1].green + b[0].green + b[1].green;
+        const int       u = t[0].blue + t[1].blue + b[0].blue + b[1].blue;
+        cb[x]             = ((-38 * r - 74 * g + 112 * u + 512) >> 10) + 128;
+        cr[x]             = ((112 * r - 94 * g - 18 * u + 512) >> 10) + 128;
+    }
+    if (width % 2) {
+        const RgbColor& t = top[width - 1];
+        const RgbColor& b = bottom[width - 1];
+        const int       r = 2 * (t.red + b.red);
+        const int       g = 2 * (t.green + b.green);
+        const int       u = 2 * (t.blue + b.blue);
+        cb[half]          = ((-38 * r - 74 * g + 112 * u + 512) >> 10) + 128;
+        cr[half]          = ((112 * r - 94 * g - 18 * u + 512) >> 10) + 128;
+    }
+}
+
+}  // namespace
+
+Y4mWriter::Y4mWriter(pn::output_view out, int rate_num, int rate_den)
+        : _out(out), _rate_num(rate_num), _rate_den(rate_den) {}
+
+void Y4mWriter::write(const PixMap& pix) {
+    const Size size = pix.size();
+    if (_frames == 0) {
+        _size = size;
+        _out.format(
+                "YUV4MPEG2 W{0} H{1} F{2}:{3} Ip A1:1 C420jpeg\n", size.width, size.height,
+                _rate_num, _rate_den);
+    } else if (size != _size) {
+        throw std::runtime_error(
+                pn::format(
+                        "frame is {0}x{1}, not {2}x{3}", size.width, size.height, _size.width,
+                        _size.height)
+                        .c_str());
+    }
+
+    const int chroma_width  = (size.width + 1) / 2;
+    const int chroma_height = (size.height + 1) / 2;
+    const int luma_bytes    = size.width * size.height;
+    const int chroma_bytes  = chroma_width * chroma_height;
+    _planes.resize(luma_bytes + (2 * chroma_bytes));
+    uint8_t* y  = _planes.data();
+    uint8_t* cb = y + luma_bytes;
+    uint8_t* cr = cb + chroma_bytes;
+
+    for (int row = 0; row < size.height; ++row) {
+        luma_row(pix.row(row), size.width, y + (row * size.width));
+    }
+    for (int row = 0; row < chroma_height; ++row) {
+        const int top    = 2 * row;
+        const int bottom = std::min(top + 1, size.height - 1);
+        chroma_row(
+                pix.row(top), pix.row(bottom), size.width, cb + (row * chroma_width),
+                cr + (row * chroma_width));
+    }
+
+    _out.format("FRAME\n");
+    _out.write(pn::data_view{_planes.data(), static_cast<int>(_planes.size())});
+    ++_frames;
+}
+
+}  // namespace antares
@@ -0,0 +1,121 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+
+#include "drawing/y4m-writer.hpp"
+
+#include <gmock/gmock.h>
+#include <pn/data>
+#include <stdexcept>
+#include <vector>
+
+using testing::ElementsAre;
+using testing::ElementsAreArray;
+using testing::Eq;
+
+namespace antares {
+namespace {
+
+using Y4mWriterTest = testing::Test;
+
+std::vector<uint8_t> bytes(const pn::data& data) {
+    return std::vector<uint8_t>(data.data(), data.data() + data.size());
+}
+
+// The first frame is preceded by the stream header, which gives its size and rate; later frames
+// are not.
+TEST_F(Y4mWriterTest, Header) {
+    pn::data  data;
+    Y4mWriter writer(data.output(), 30000, 1001);
+
+    ArrayPixMap pix(4, 2);
+    pix.fill(RgbColor::black());
+    writer.write(pix);
+    const pn::string_view header =
+            "YUV4MPEG2 W4 H2 F30000:1001 Ip A1:1 C420jpeg\n"
+            "FRAME\n";
+    ASSERT_THAT(data.as_string().size(), Eq(header.size() + 8 + 2 + 2));
+    EXPECT_THAT(data.as_string().substr(0, header.size()), Eq(header));
+
+    writer.write(pix);
+    const pn::string_view frame = "FRAME\n";
+    ASSERT_THAT(data.as_string().size(), Eq(header.size() + 2 * (8 + 2 + 2) + frame.size()));
+    EXPECT_THAT(data.as_string().substr(header.size() + 12, frame.size()), Eq(frame));
+}
+
+// Black and white are at the ends of limited range, and have neutral chroma.
+TEST_F(Y4mWriterTest, BlackAndWhite) {
+    pn::data  data;
+    Y4mWriter writer(data.output(), 1, 1);
+
+    ArrayPixMap pix(2, 2);
+    pix.set(0, 0, RgbColor::black());
+    pix.set(1, 0, RgbColor::white());
+    pix.set(0, 1, RgbColor::white());
+    pix.set(1, 1, RgbColor::black());
+    writer.write(pix);
+
+    std::vector<uint8_t> planes = bytes(data);
+    planes.erase(planes.begin(), planes.end() - 6);
+    EXPECT_THAT(planes, ElementsAre(16, 235, 235, 16, 128, 128));
+}
+
+// With an odd width or height, the last column or row has chroma samples of its own, from only
+// that column or row.
+TEST_F(Y4mWriterTest, OddSize) {
+    pn::data  data;
+    Y4mWriter writer(data.output(), 1, 1);
+
+    ArrayPixMap pix(3, 3);
+    pix.fill(RgbColor::white());
+    pix.set(2, 0, rgb(255, 0, 0));
+    pix.set(2, 1, rgb(255, 0, 0));
+    pix.set(0, 2, rgb(255, 0, 0));
+    pix.set(1, 2, rgb(255, 0, 0));
+    pix.set(2, 2, rgb(255, 0, 0));
+    writer.write(pix);
+
+    const pn::string_view header = "YUV4MPEG2 W3 H3 F1:1 Ip A1:1 C420jpeg\nFRAME\n";
+    EXPECT_THAT(data.as_string().substr(0, header.size()), Eq(header));
+
+    std::vector<uint8_t> planes = bytes(data);
+    planes.erase(planes.begin(), planes.begin() + header.size());
+    const uint8_t y[]  = {235, 235, 82, 235, 235, 82, 82, 82, 82};
+    const uint8_t cb[] = {128, 90, 90, 90};
+    const uint8_t cr[] = {128, 240, 240, 240};
+    ASSERT_THAT(planes.size(), Eq(9u + 4u + 4u));
+    EXPECT_THAT(std::vector<uint8_t>(planes.begin(), planes.begin() + 9), ElementsAreArray(y));
+    EXPECT_THAT(
+            std::vector<uint8_t>(planes.begin() + 9, planes.begin() + 13), ElementsAreArray(cb));
+    EXPECT_THAT(std::vector<uint8_t>(planes.begin() + 13, planes.end()), ElementsAreArray(cr));
+}
+
+TEST_F(Y4mWriterTest, SizeMismatch) {
+    pn::data  data;
+    Y4mWriter writer(data.output(), 1, 1);
+
+    ArrayPixMap first(4, 4);
+    first.fill(RgbColor::black());
+    writer.write(first);
+
+    ArrayPixMap second(4, 3);
+    second.fill(RgbColor::black());
+    EXPECT_THROW(writer.write(second), std::runtime_error);
+}
+
+}  // namespace
+}  // namespace antares
@@ -916,4 +916,15 @@ void execute_action_queue() {
     }
 }
 
+std::vector<QueuedActions> queued_actions() {
+    std::vector<QueuedActions> result;
+    for (const actionQueueType* q = g.action_queue.first; q && !q->empty();
+         q = q->nextActionQueue) {
+        result.push_back(QueuedActions{
+                q->scheduledTime, q->cursor.begin, q->cursor.end, q->cursor.subject,
+                q->cursor.subject_id, q->cursor.direct, q->cursor.direct_id, q->cursor.offset});
+    }
+    return result;
+}
+
 }  // namespace antares
@@ -44,6 +44,7 @@
 #include "game/instruments.hpp"
 #include "game/labels.hpp"
 #include "game/level.hpp"
+#include "game/memory-report.hpp"
 #include "game/messages.hpp"
 #include "game/minicomputer.hpp"
 #include "game/motion.hpp"
@@ -222,6 +223,26 @@ void MainPlay::become_front() {
     }
 }
 
+void advance_world(ticks units, const std::function<void()>& input) {
+    MoveSpaceObjects(units);
+
+    g.time += units;
+
+    if ((g.time.time_since_epoch() % kMajorTick) == ticks(0)) {
+        // everything in here gets executed once every major tick
+        NonplayerShipThink();
+        AdmiralThink();
+        execute_action_queue();
+
+        input();
+
+        CollideSpaceObjects();
+        if ((g.time.time_since_epoch() % kConditionTick) == ticks(0)) {
+            CheckLevelConditions();
+        }
+    }
+}
+
 GamePlay::GamePlay(bool replay, InputSource* input, GameResult* game_result)
         : _state(PLAYING),
           _replay(replay),
@@ -464,29 +485,14 @@ void GamePlay::fire_timer() {
         // executed arbitrarily, but at least once every major tick
         globals()->starfield.prepare_to_move();
         globals()->starfield.move(unitsToDo);
-        MoveSpaceObjects(unitsToDo);
-
-        g.time += unitsToDo;
-
-        if ((g.time.time_since_epoch() % kMajorTick) == ticks(0)) {
-            // everything in here gets executed once every major tick
+        advance_world(unitsToDo, [this] {
             _player_paused = false;
-
-            NonplayerShipThink();
-            AdmiralThink();
-            execute_action_queue();
-
             if (!_input_source->get(g.admiral, g.time, _player_ship)) {
                 g.game_over    = true;
                 g.game_over_at = g.time;
             }
             _player_ship.update();
-
-            CollideSpaceObjects();
-            if ((g.time.time_since_epoch() % kConditionTick) == ticks(0)) {
-                CheckLevelConditions();
-            }
-        }
+        });
 
         UpdateMiniScreenLines();
 
@@ -610,6 +616,9 @@ void GamePlay::key_down(const KeyDownEvent& event) {
             } else if (event.key() == sys.prefs->key(kFastMotionKeyNum)) {
                 _fast_motion = true;
                 return;
+            } else if (event.key() == Key::F15) {
+                report_memory(pn::err);  // debugging aid; not bindable.
+                return;
             }
     }
 
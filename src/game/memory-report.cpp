@@ -0,0 +1,97 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "game/memory-report.hpp"
+
+#include "data/base-object.hpp"
+#include "data/level.hpp"
+#include "data/plugin.hpp"
+#include "data/races.hpp"
+#include "drawing/sprite-handling.hpp"
+#include "drawing/text.hpp"
+#include "game/admiral.hpp"
+#include "game/globals.hpp"
+#include "game/labels.hpp"
+#include "game/space-object.hpp"
+#include "game/sys.hpp"
+#include "game/vector.hpp"
+#include "video/driver.hpp"
+
+namespace antares {
+
+namespace {
+
+int64_t texture_bytes(const Texture& texture) {
+    if (!texture) {
+        return 0;
+    }
+    return int64_t{4} * texture.size().width * texture.size().height;
+}
+
+template <typename T>
+void report_pool(pn::output_view out, pn::string_view name, HandleList<T> all) {
+    out.format("pool/{0}/slots\t{1}\n", name, int64_t(all.size()));
+    out.format("pool/{0}/bytes\t{1}\n", name, int64_t(sizeof(T) * all.size()));
+}
+
+}  // namespace
+
+void report_memory(pn::output_view out) {
+    out.format("sprites/sheets\t{0}\n", sys.pix.sheet_count());
+    out.format("sprites/tables\t{0}\n", sys.pix.table_count());
+    out.format("sprites/decoded_bytes\t{0}\n", sys.pix.sheet_bytes());
+    out.format("sprites/atlas_bytes\t{0}\n", sys.video ? sys.video->atlas_bytes() : int64_t{0});
+
+    const Font* fonts[] = {&sys.fonts.tactical, &sys.fonts.computer, &sys.fonts.button,
+                           &sys.fonts.title, &sys.fonts.small_button};
+    int64_t font_bytes = 0;
+    for (const Font* font : fonts) {
+        font_bytes += texture_bytes(font->texture);
+    }
+    out.format("fonts/bytes\t{0}\n", font_bytes);
+
+    out.format("sounds/loaded\t{0}\n", sys.sound.loaded());
+    out.format("sounds/bytes\t{0}\n", sys.sound.bytes());
+
+    if (plug.data) {
+        const ScenarioData& data = *plug.data;
+        out.format("scenario/levels\t{0}\n", int64_t(data.levels.size()));
+        out.format("scenario/objects\t{0}\n", int64_t(data.objects.size()));
+        out.format("scenario/races\t{0}\n", int64_t(data.races.size()));
+        out.format(
+                "scenario/bytes\t{0}\n",
+                int64_t((sizeof(Level) * data.levels.size()) +
+                        (sizeof(BaseObject) * data.objects.size()) +
+                        (sizeof(Race) * data.races.size())));
+    }
+
+    if (g.objects) {
+        int64_t in_use = 0;
+        for (Handle<SpaceObject> o : SpaceObject::all()) {
+            in_use += (o->active != kObjectAvailable);
+        }
+        out.format("pool/objects/in_use\t{0}\n", in_use);
+        report_pool(out, "objects", SpaceObject::all());
+        report_pool(out, "vectors", Vector::all());
+        report_pool(out, "sprites", Sprite::all());
+        report_pool(out, "admirals", Admiral::all());
+        report_pool(out, "destinations", Destination::all());
+        report_pool(out, "labels", Label::all());
+    }
+}
+
+}  // namespace antares
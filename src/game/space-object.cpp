@@ -85,7 +85,7 @@ BaseObject* BaseObject::get(int number) { return get(pn::dump(number, pn::dump_s
 BaseObject* BaseObject::get(pn::string_view name) {
     auto it = plug.objects.find(name.copy());
     if (it != plug.objects.end()) {
-        return &it->second;
+        return it->second;
     }
     return nullptr;
 }
@@ -497,8 +497,8 @@ void SpaceObject::change_base_type(
         obj->sprite->table = spriteTable;
         obj->sprite->icon =
                 base.icon.value_or(BaseObject::Icon{BaseObject::Icon::Shape::SQUARE, 0});
-        obj->sprite->whichLayer = sprite_layer(base);
-        obj->sprite->scale      = sprite_scale(base);
+        SetSpriteLayer(obj->sprite, sprite_layer(base));
+        obj->sprite->scale = sprite_scale(base);
 
         if (obj->attributes & kIsSelfAnimated) {
             obj->sprite->whichShape = more_evil_fixed_to_long(obj->frame.animation.thisShape);
@@ -0,0 +1,360 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "game/state-dump.hpp"
+
+#include <map>
+#include <sfz/sfz.hpp>
+#include <type_traits>
+#include <utility>
+
+#include "data/base-object.hpp"
+#include "data/plugin.hpp"
+#include "game/action.hpp"
+#include "game/admiral.hpp"
+#include "game/globals.hpp"
+#include "game/space-object.hpp"
+#include "game/vector.hpp"
+
+using sfz::dec;
+using sfz::range;
+
+namespace antares {
+
+namespace {
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value, pn::string>::type repr(T x) {
+    return pn::dump(int64_t(x), pn::dump_short);
+}
+
+pn::string repr(bool x) { return x ? "true" : "false"; }
+pn::string repr(Fixed x) { return stringify(x); }
+pn::string repr(Scale x) { return repr(x.factor); }
+pn::string repr(Random x) { return repr(x.seed); }
+pn::string repr(ticks x) { return repr(x.count()); }
+pn::string repr(game_ticks x) { return repr(x.time_since_epoch().count()); }
+pn::string repr(Point x) { return pn::format("{0}, {1}", x.h, x.v); }
+pn::string repr(Rect x) { return stringify(x); }
+pn::string repr(const RgbColor& x) { return stringify(x); }
+pn::string repr(fixedPointType x) {
+    return pn::format("{0}, {1}", stringify(x.h), stringify(x.v));
+}
+pn::string repr(pn::string_view x) { return pn::dump(x, pn::dump_short); }
+
+template <typename T>
+pn::string repr(Handle<T> x) {
+    return repr(x.number());
+}
+
+template <typename T>
+pn::string repr(const sfz::optional<T>& x) {
+    return x.has_value() ? repr(*x) : pn::string{"-"};
+}
+
+class StateWriter {
+  public:
+    StateWriter(pn::output_view out) : _out(out) {
+        for (const auto& kv : plug.objects) {
+            _names[kv.second] = kv.first;
+        }
+    }
+
+    template <typename T>
+    void field(pn::string_view prefix, pn::string_view name, const T& value) {
+        _out.format("{0}{1}\t{2}\n", prefix, name, repr(value));
+    }
+
+    void base(pn::string_view prefix, pn::string_view name, const BaseObject* base) {
+        if (!base) {
+            field(prefix, name, pn::string_view{"-"});
+            return;
+        }
+        auto it = _names.find(base);
+        field(prefix, name, (it == _names.end()) ? pn::string_view{"?"} : it->second);
+    }
+
+  private:
+    pn::output_view                                _out;
+    std::map<const BaseObject*, pn::string_view> _names;
+};
+
+void dump_globals(StateWriter& w) {
+    const pn::string_view p = "global/";
+    w.field(p, "time", g.time);
+    w.field(p, "sync", g.sync);
+    w.field(p, "random", g.random);
+    w.field(p, "angle", g.angle);
+    w.field(p, "admiral", g.admiral);
+    w.field(p, "ship", g.ship);
+    w.field(p, "root", g.root);
+    w.field(p, "game_over", g.game_over);
+    w.field(p, "game_over_at", g.game_over_at);
+    w.field(p, "victor", g.victor);
+    w.field(p, "radar_count", g.radar_count);
+    w.field(p, "radar_on", g.radar_on);
+    w.field(p, "key_mask", g.key_mask);
+    w.field(p, "zoom", static_cast<int>(g.zoom));
+    w.field(p, "closest", g.closest);
+    w.field(p, "farthest", g.farthest);
+    for (size_t i : range(g.initials.size())) {
+        w.field(pn::format("{0}initial/{1}/", p, dec(i, 3)), "object", g.initials[i]);
+        w.field(pn::format("{0}initial/{1}/", p, dec(i, 3)), "id", g.initial_ids[i]);
+    }
+    for (size_t i : range(g.condition_enabled.size())) {
+        w.field(pn::format("{0}condition/{1}/", p, dec(i, 3)), "enabled",
+                bool(g.condition_enabled[i]));
+    }
+}
+
+void dump_admirals(StateWriter& w) {
+    for (Handle<Admiral> a : Admiral::all()) {
+        if (!a->active()) {
+            continue;
+        }
+        const pn::string p = pn::format("admiral/{0}/", a.number());
+        w.field(p, "name", a->name());
+        w.field(p, "race", a->race().name());
+        w.field(p, "hue", static_cast<int>(a->hue()));
+        w.field(p, "attributes", a->attributes());
+        w.field(p, "cheats", a->cheats());
+        w.field(p, "control", a->control());
+        w.field(p, "target", a->target());
+        w.field(p, "flagship", a->flagship());
+        w.field(p, "has_destination", a->has_destination());
+        w.field(p, "destination_object", a->destinationObject());
+        w.field(p, "destination_object_id", a->destinationObjectID());
+        w.field(p, "consider_ship", a->considerShip());
+        w.field(p, "consider_ship_id", a->considerShipID());
+        w.field(p, "consider_destination", a->considerDestination());
+        w.field(p, "build_at", a->buildAtObject());
+        w.field(p, "cash", a->cash().amount);
+        w.field(p, "save_goal", a->saveGoal().amount);
+        w.field(p, "earning_power", a->earning_power());
+        w.field(p, "kills", a->kills());
+        w.field(p, "losses", a->losses());
+        w.field(p, "ships_left", a->shipsLeft());
+        for (int i : range(kAdmiralScoreNum)) {
+            w.field(p, pn::format("score/{0}", i), a->score()[i]);
+        }
+        w.field(p, "blitzkrieg", a->blitzkrieg());
+        w.field(p, "last_free_escort_strength", a->lastFreeEscortStrength());
+        w.field(p, "this_free_escort_strength", a->thisFreeEscortStrength());
+        w.field(p, "total_build_chance", a->totalBuildChance());
+        w.field(p, "can_build", a->canBuildType().size());
+        if (a->hopeToBuild().has_value()) {
+            w.field(p, "hope_to_build", pn::string_view{a->hopeToBuild()->name});
+        } else {
+            w.field(p, "hope_to_build", pn::string_view{"-"});
+        }
+    }
+}
+
+void dump_destinations(StateWriter& w) {
+    for (Handle<Destination> d : Destination::all()) {
+        if (d->whichObject == SpaceObject::none()) {
+            continue;
+        }
+        const pn::string p = pn::format("destination/{0}/", dec(d.number(), 2));
+        w.field(p, "object", d->whichObject);
+        w.field(p, "name", pn::string_view{d->name});
+        for (int i : range<int>(kMaxPlayerNum)) {
+            w.field(p, pn::format("occupied/{0}", i), d->occupied[i]);
+        }
+        w.field(p, "earn", d->earn);
+        w.field(p, "build_time", d->buildTime);
+        w.field(p, "total_build_time", d->totalBuildTime);
+        w.base(p, "build_object", d->buildObjectBaseNum);
+    }
+}
+
+void dump_weapon(StateWriter& w, pn::string_view prefix, const SpaceObject::Weapon& weapon) {
+    w.base(prefix, "base", weapon.base);
+    w.field(prefix, "time", weapon.time);
+    w.field(prefix, "ammo", weapon.ammo);
+    w.field(prefix, "position", weapon.position);
+    w.field(prefix, "charge", weapon.charge);
+}
+
+void dump_object(StateWriter& w, Handle<SpaceObject> h) {
+    const SpaceObject& o = *h;
+    const pn::string   p = pn::format("object/{0}/", dec(h.number(), 3));
+
+    w.field(p, "id", o.id);
+    w.base(p, "base", o.base);
+    w.field(p, "active", o.active);
+    w.field(p, "attributes", o.attributes);
+    w.field(p, "owner", o.owner);
+    w.field(p, "keys_down", o.keysDown);
+    w.field(p, "direction", o.direction);
+    w.field(p, "direction_goal", o.directionGoal);
+    w.field(p, "turn_velocity", o.turnVelocity);
+    w.field(p, "turn_fraction", o.turnFraction);
+    w.field(p, "offline_time", o.offlineTime);
+    w.field(p, "location", o.location);
+    w.field(p, "collision_grid", o.collisionGrid);
+    w.field(p, "distance_grid", o.distanceGrid);
+    w.field(p, "next_near_object", o.nextNearObject);
+    w.field(p, "next_far_object", o.nextFarObject);
+    w.field(p, "previous_object", o.previousObject);
+    w.field(p, "next_object", o.nextObject);
+    w.field(p, "runtime_flags", o.runTimeFlags);
+    w.field(p, "destination_location", o.destinationLocation);
+    w.field(p, "dest_object", o.destObject);
+    w.field(p, "dest_object_dest", o.destObjectDest);
+    w.field(p, "as_destination", o.asDestination);
+    w.field(p, "dest_object_id", o.destObjectID);
+    w.field(p, "dest_object_dest_id", o.destObjectDestID);
+    w.field(p, "local_friend_strength", o.localFriendStrength);
+    w.field(p, "local_foe_strength", o.localFoeStrength);
+    w.field(p, "escort_strength", o.escortStrength);
+    w.field(p, "remote_friend_strength", o.remoteFriendStrength);
+    w.field(p, "remote_foe_strength", o.remoteFoeStrength);
+    w.field(p, "best_considered_target_value", o.bestConsideredTargetValue);
+    w.field(p, "current_target_value", o.currentTargetValue);
+    w.field(p, "best_considered_target", o.bestConsideredTargetNumber);
+    w.field(p, "time_from_origin", o.timeFromOrigin);
+    w.field(p, "ideal_location_calc", o.idealLocationCalc);
+    w.field(p, "origin_location", o.originLocation);
+    w.field(p, "motion_fraction", o.motionFraction);
+    w.field(p, "velocity", o.velocity);
+    w.field(p, "thrust", o.thrust);
+    w.field(p, "max_velocity", o.maxVelocity);
+    w.field(p, "absolute_bounds", o.absoluteBounds);
+    w.field(p, "random", o.randomSeed);
+    w.field(p, "frame/shape", o.frame.animation.thisShape);
+    w.field(p, "frame/fraction", o.frame.animation.frameFraction);
+    w.field(p, "frame/direction", static_cast<int>(o.frame.animation.direction));
+    w.field(p, "frame/speed", o.frame.animation.speed);
+    w.field(p, "frame/vector", o.frame.vector);
+    w.field(p, "health", o.health());
+    w.field(p, "energy", o.energy());
+    w.field(p, "battery", o.battery());
+    w.field(p, "warp_energy_collected", o.warpEnergyCollected);
+    w.field(p, "expires", o.expires);
+    w.field(p, "expire_after", o.expire_after);
+    w.field(p, "natural_scale", o.naturalScale);
+    w.field(p, "recharge_time", o.rechargeTime);
+    w.field(p, "layer", static_cast<int>(o.layer));
+    w.field(p, "sprite", o.sprite);
+    w.field(p, "distance_from_player", o.distanceFromPlayer);
+    w.field(p, "closest_distance", o.closestDistance);
+    w.field(p, "closest_object", o.closestObject);
+    w.field(p, "target_object", o.targetObject);
+    w.field(p, "target_object_id", o.targetObjectID);
+    w.field(p, "target_angle", o.targetAngle);
+    w.field(p, "last_target", o.lastTarget);
+    w.field(p, "last_target_distance", o.lastTargetDistance);
+    w.field(p, "longest_weapon_range", o.longestWeaponRange);
+    w.field(p, "shortest_weapon_range", o.shortestWeaponRange);
+    w.field(p, "engage_range", o.engageRange);
+    w.field(p, "presence", static_cast<int>(o.presenceState));
+    switch (o.presenceState) {
+        case kNormalPresence: break;
+        case kLandingPresence:
+            w.field(p, "presence/speed", o.presence.landing.speed);
+            w.field(p, "presence/scale", o.presence.landing.scale);
+            break;
+        case kWarpInPresence:
+            w.field(p, "presence/step", o.presence.warp_in.step);
+            w.field(p, "presence/progress", o.presence.warp_in.progress);
+            break;
+        case kWarpingPresence: w.field(p, "presence/warping", o.presence.warping); break;
+        case kWarpOutPresence: w.field(p, "presence/warp_out", o.presence.warp_out); break;
+    }
+    w.field(p, "hit_state", o.hitState);
+    w.field(p, "cloak_state", o.cloakState);
+    w.field(p, "duty", static_cast<int>(o.duty));
+    if (o.pix_id.has_value()) {
+        w.field(p, "pix/name", o.pix_id->name);
+        w.field(p, "pix/hue", static_cast<int>(o.pix_id->hue));
+    }
+    dump_weapon(w, pn::format("{0}pulse/", p), o.pulse);
+    dump_weapon(w, pn::format("{0}beam/", p), o.beam);
+    dump_weapon(w, pn::format("{0}special/", p), o.special);
+    w.field(p, "periodic_time", o.periodicTime);
+    w.field(p, "my_player_flag", o.myPlayerFlag);
+    w.field(p, "seen_by_player_flags", o.seenByPlayerFlags);
+    w.field(p, "hostile_towards_flags", o.hostileTowardsFlags);
+    w.field(p, "shield_color", o.shieldColor);
+    w.field(p, "original_color", o.originalColor);
+}
+
+void dump_objects(StateWriter& w) {
+    for (Handle<SpaceObject> o : SpaceObject::all()) {
+        if (o->active != kObjectAvailable) {
+            dump_object(w, o);
+        }
+    }
+}
+
+void dump_vectors(StateWriter& w) {
+    for (Handle<Vector> v : Vector::all()) {
+        if (!v->active) {
+            continue;
+        }
+        const pn::string p = pn::format("vector/{0}/", dec(v.number(), 3));
+        w.field(p, "is_ray", v->is_ray);
+        w.field(p, "to_coord", v->to_coord);
+        w.field(p, "lightning", v->lightning);
+        w.field(p, "last_global_location", v->lastGlobalLocation);
+        w.field(p, "object_location", v->objectLocation);
+        w.field(p, "kill_me", v->killMe);
+        w.field(p, "from_object", v->fromObject);
+        w.field(p, "from_object_id", v->fromObjectID);
+        w.field(p, "to_object", v->toObject);
+        w.field(p, "to_object_id", v->toObjectID);
+        w.field(p, "to_relative_coord", v->toRelativeCoord);
+        w.field(p, "bolt_state", v->boltState);
+        w.field(p, "accuracy", v->accuracy);
+        w.field(p, "range", v->range);
+    }
+}
+
+// Entries are keyed by their subject's id and the type of their first action, and numbered only
+// among entries that share both, so that an entry queued in one dump but not the other doesn't
+// change the keys of those after it.
+void dump_action_queue(StateWriter& w) {
+    std::map<std::pair<int32_t, int>, int> seen;
+    for (const QueuedActions& q : queued_actions()) {
+        const int        type = static_cast<int>(q.begin->type());
+        const int        n    = seen[std::make_pair(q.subject_id, type)]++;
+        const pn::string p    = pn::format("action/{0}.{1}.{2}/", q.subject_id, type, n);
+        w.field(p, "scheduled_time", q.scheduled_time);
+        w.field(p, "type", type);
+        w.field(p, "count", q.end - q.begin);
+        w.field(p, "subject", q.subject);
+        w.field(p, "subject_id", q.subject_id);
+        w.field(p, "direct", q.direct);
+        w.field(p, "direct_id", q.direct_id);
+        w.field(p, "offset", q.offset);
+    }
+}
+
+}  // namespace
+
+void dump_state(pn::output_view out) {
+    StateWriter w(out);
+    dump_globals(w);
+    dump_admirals(w);
+    dump_destinations(w);
+    dump_objects(w);
+    dump_vectors(w);
+    dump_action_queue(w);
+}
+
+}  // namespace antares
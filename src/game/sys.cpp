@@ -41,6 +41,14 @@ constexpr char kInstRightPictID[] = "gui/instruments/right";
 
 ANTARES_GLOBAL SystemGlobals sys;
 
+// The rotation table is the same for every scenario, so threads that each play their own game
+// (e.g. `replay --batch`) can share it, instead of each loading a copy.
+static std::shared_ptr<const std::vector<int32_t>> rotation_table() {
+    static const std::shared_ptr<const std::vector<int32_t>> table =
+            std::make_shared<const std::vector<int32_t>>(Resource::rotation_table());
+    return table;
+}
+
 void sys_init() {
     sys.fonts.tactical     = font("tactical");
     sys.fonts.computer     = font("computer");
@@ -53,7 +61,7 @@ void sys_init() {
     sys.gamepad_names      = Resource::strings(Gamepad::kNameStrings);
     sys.gamepad_long_names = Resource::strings(Gamepad::kLongNameStrings);
 
-    sys.rot_table = Resource::rotation_table();
+    sys.rot_table = rotation_table();
 
     sys.messages     = Resource::strings(kMessageStrings);
     sys.minicomputer = Resource::strings(kMinicomputerStrings);
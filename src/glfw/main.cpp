@@ -60,7 +60,8 @@ void usage(pn::output_view out, pn::string_view progname, int retcode) {
             "                        (default: {2})\n"
             "    -f, --factory       set path to factory scenario\n"
             "                        (default: {3})\n"
-            "    -h, --help          display this help screen\n",
+            "    -h, --help          display this help screen\n"
+            "        --frame-stats   print frame pacing statistics to stderr at exit\n",
             progname, default_application_path(), default_config_path(),
             default_factory_scenario_path());
     exit(retcode);
@@ -93,20 +94,25 @@ void main(int argc, char* const* argv) {
         }
     };
 
-    callbacks.long_option =
-            [&callbacks](pn::string_view opt, const args::callbacks::get_value_f& get_value) {
-                if (opt == "app-data") {
-                    return callbacks.short_option(pn::rune{'a'}, get_value);
-                } else if (opt == "config") {
-                    return callbacks.short_option(pn::rune{'c'}, get_value);
-                } else if (opt == "factory-scenario") {
-                    return callbacks.short_option(pn::rune{'f'}, get_value);
-                } else if (opt == "help") {
-                    return callbacks.short_option(pn::rune{'h'}, get_value);
-                } else {
-                    return false;
-                }
-            };
+    bool frame_stats      = false;
+    callbacks.long_option = [&callbacks, &frame_stats](
+                                    pn::string_view                     opt,
+                                    const args::callbacks::get_value_f& get_value) {
+        if (opt == "app-data") {
+            return callbacks.short_option(pn::rune{'a'}, get_value);
+        } else if (opt == "config") {
+            return callbacks.short_option(pn::rune{'c'}, get_value);
+        } else if (opt == "factory-scenario") {
+            return callbacks.short_option(pn::rune{'f'}, get_value);
+        } else if (opt == "help") {
+            return callbacks.short_option(pn::rune{'h'}, get_value);
+        } else if (opt == "frame-stats") {
+            frame_stats = true;
+            return true;
+        } else {
+            return false;
+        }
+    };
 
     args::parse(argc - 1, argv + 1, callbacks);
 
@@ -129,6 +135,16 @@ void main(int argc, char* const* argv) {
     OpenAlSoundDriver sound;
     GLFWVideoDriver   video;
     video.loop(new Master(scenario, time(NULL)));
+    if (frame_stats) {
+        const GLFWVideoDriver::FrameStats& stats = video.frame_stats();
+        pn::err.format("{0} frames, {1} late\n", stats.frames, stats.late);
+        if (stats.paced) {
+            pn::err.format(
+                    "{0} back to back: {1} us mean, {2} us shortest, {3} us longest\n",
+                    stats.paced, stats.total.count() / stats.paced, stats.shortest.count(),
+                    stats.longest.count());
+        }
+    }
 }
 
 }  // namespace
@@ -19,6 +19,7 @@
 #include "glfw/video-driver.hpp"
 
 #include <GLFW/glfw3.h>
+#include <algorithm>
 
 #include <game/sys.hpp>
 #include <pn/output>
@@ -39,6 +40,15 @@ namespace antares {
 
 static const ticks kDoubleClickInterval = ticks(30);
 
+// Sprite atlas pages are uploaded as they are first drawn. A large page can take a few
+// milliseconds to upload, so only a couple are uploaded per frame, and the rest are drawn a frame
+// or two later instead of stalling.
+static const int64_t kTextureBudget      = int64_t{256} << 20;
+static const int     kMaxUploadsPerFrame = 2;
+
+// Assumed when the display doesn't report its refresh rate.
+static const int kDefaultRefreshRate = 60;
+
 static Key glfw_key_to_usb(int key) {
     switch (key) {
         case GLFW_KEY_SPACE: return Key::SPACE;
@@ -171,11 +181,13 @@ GLFWVideoDriver::GLFWVideoDriver()
         : _fullscreen(sys.prefs->fullscreen()),
           _screen_size(sys.prefs->window_size()),
           _last_click_count(0),
-          _text(nullptr) {
+          _text(nullptr),
+          _redraw(false) {
     if (!glfwInit()) {
         throw std::runtime_error("glfwInit()");
     }
     glfwSetErrorCallback(throw_error);
+    set_texture_limits(kTextureBudget, kMaxUploadsPerFrame);
 }
 
 GLFWVideoDriver::~GLFWVideoDriver() { glfwTerminate(); }
@@ -421,34 +433,45 @@ void GLFWVideoDriver::window_maximize(bool maximized) {
 
 void GLFWVideoDriver::key_callback(GLFWwindow* w, int key, int scancode, int action, int mods) {
     GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
+    driver->redraw();
     driver->key(key, scancode, action, mods);
 }
 
 void GLFWVideoDriver::char_callback(GLFWwindow* w, unsigned int code_point) {
     GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
+    driver->redraw();
     driver->char_(code_point);
 }
 
 void GLFWVideoDriver::mouse_button_callback(GLFWwindow* w, int button, int action, int mods) {
     GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
+    driver->redraw();
     driver->mouse_button(button, action, mods);
 }
 
 void GLFWVideoDriver::mouse_move_callback(GLFWwindow* w, double x, double y) {
     GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
+    driver->redraw();
     driver->mouse_move(x, y);
 }
 
 void GLFWVideoDriver::window_size_callback(GLFWwindow* w, int width, int height) {
     GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
+    driver->redraw();
     driver->window_size(width, height);
 }
 
 void GLFWVideoDriver::window_maximize_callback(GLFWwindow* w, int maximized) {
     GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
+    driver->redraw();
     driver->window_maximize(maximized);
 }
 
+void GLFWVideoDriver::window_refresh_callback(GLFWwindow* w) {
+    GLFWVideoDriver* driver = reinterpret_cast<GLFWVideoDriver*>(glfwGetWindowUserPointer(w));
+    driver->redraw();
+}
+
 pn::string_view hint_opengl20() {
     glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
@@ -503,31 +526,104 @@ void GLFWVideoDriver::loop(Card* initial) {
     glfwSetMouseButtonCallback(_window, mouse_button_callback);
     glfwSetCursorPosCallback(_window, mouse_move_callback);
     glfwSetWindowSizeCallback(_window, window_size_callback);
+    glfwSetWindowRefreshCallback(_window, window_refresh_callback);
 
     /* Make the _window's context current */
     glfwMakeContextCurrent(_window);
 
+    // Frames are drawn at most once per swap interval, so that the loop sleeps rather than
+    // drawing frames that would never be shown.
+    const int swap_interval = sys.prefs->swap_interval();
+    glfwSwapInterval(swap_interval);
+    const GLFWvidmode* display      = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    int                refresh_rate = kDefaultRefreshRate;
+    if (display && (display->refreshRate > 0)) {
+        refresh_rate = display->refreshRate;
+    }
+    _frame_interval = usecs(1000000 * std::max(swap_interval, 1) / refresh_rate);
+
     MainLoop main_loop(*this, initial);
     _loop = &main_loop;
-    main_loop.draw();
+    redraw();
 
+    wall_time next_frame = now();
     while (!main_loop.done() && !glfwWindowShouldClose(_window)) {
-        glfwPollEvents();
-        _loop->draw();
-        glfwSwapBuffers(_window);
+        wait(next_frame);
+
+        // A card that has fallen behind catches up in fire_timer(), so one call is enough, and
+        // the frame drawn after it shows every tick that passed.
         wall_time at;
-        if (main_loop.top()->next_timer(at) && (now() > at)) {
+        if (!main_loop.done() && main_loop.top()->next_timer(at) && (now() >= at)) {
             main_loop.top()->fire_timer();
-            main_loop.draw();
-            glfwSwapBuffers(_window);
-        } else {
+            redraw();
+        }
+
+        if (!main_loop.done() && _redraw && (now() >= next_frame)) {
+            const wall_time start = now();
+            swap(next_frame);
+            next_frame = start + _frame_interval;
+        }
+    }
+}
+
+// Something has changed since the last frame, so another must be drawn.
+void GLFWVideoDriver::redraw() {
+    if (!_redraw) {
+        _redraw       = true;
+        _redraw_since = now();
+    }
+}
+
+// Handles events until the next thing to be done: drawing a frame, if one is needed and
+// `next_frame` allows, or firing the top card's timer. With neither, waits for an event.
+void GLFWVideoDriver::wait(wall_time next_frame) {
+    wall_time at;
+    bool      timed = _loop->top()->next_timer(at);
+    if (_redraw && (!timed || (next_frame < at))) {
+        at    = next_frame;
+        timed = true;
+    }
+
+    if (!timed) {
+        glfwWaitEvents();
+        return;
+    }
+    const usecs timeout = at - now();
+    if (timeout <= usecs(0)) {
+        glfwPollEvents();
+        return;
+    }
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 2)
+    glfwWaitEventsTimeout(timeout.count() / 1e6);
+#else
+    glfwPollEvents();
 #ifdef _MSC_VER
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
+    std::this_thread::sleep_for(std::min(timeout, usecs(1000)));
 #else
-            usleep(10);
+    usleep(std::min<int64_t>(timeout.count(), 1000));
 #endif
-        }
+#endif
+}
+
+void GLFWVideoDriver::swap(wall_time next_frame) {
+    const wall_time due = std::max(next_frame, _redraw_since);
+    _redraw             = false;
+    _loop->draw();
+    glfwSwapBuffers(_window);
+
+    const wall_time shown = now();
+    ++_frame_stats.frames;
+    if (shown > (due + _frame_interval + (_frame_interval / 2))) {
+        ++_frame_stats.late;
+    }
+    if ((_frame_stats.frames > 1) && (due == next_frame)) {
+        const usecs interval = shown - _last_shown;
+        ++_frame_stats.paced;
+        _frame_stats.total += interval;
+        _frame_stats.shortest = std::min(_frame_stats.shortest, interval);
+        _frame_stats.longest  = std::max(_frame_stats.longest, interval);
     }
+    _last_shown = shown;
 }
 
 }  // namespace antares
@@ -0,0 +1,202 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "sim/simulation.hpp"
+
+#include "config/keys.hpp"
+#include "config/preferences.hpp"
+#include "data/level.hpp"
+#include "data/plugin.hpp"
+#include "drawing/sprite-handling.hpp"
+#include "game/condition.hpp"
+#include "game/globals.hpp"
+#include "game/instruments.hpp"
+#include "game/labels.hpp"
+#include "game/level.hpp"
+#include "game/main.hpp"
+#include "game/messages.hpp"
+#include "game/sys.hpp"
+#include "sound/driver.hpp"
+#include "video/driver.hpp"
+
+namespace antares {
+
+namespace {
+
+// Loads textures without keeping their pixels or decoding sprites, and draws nothing. Time is game
+// time, so that anything timed by now() advances with the simulation.
+class HeadlessVideoDriver : public VideoDriver {
+  public:
+    virtual Point     get_mouse() { return Point(0, 0); }
+    virtual InputMode input_mode() const { return KEYBOARD_MOUSE; }
+    virtual int       scale() const { return 1; }
+    virtual Size      screen_size() const { return {640, 480}; }
+
+    virtual bool start_editing(TextReceiver* text) { return false; }
+    virtual void stop_editing(TextReceiver* text) {}
+
+    virtual wall_time now() const { return wall_time(g.time.time_since_epoch()); }
+
+    virtual Texture texture(pn::string_view name, const PixMap& content, int scale) {
+        return std::unique_ptr<Texture::Impl>(new TextureImpl(name, content.size()));
+    }
+    virtual TextureAtlas atlas(Size size, AtlasLoader load) {
+        return std::unique_ptr<TextureAtlas::Impl>(new TextureAtlasImpl);
+    }
+    virtual void dither_rect(const Rect& rect, const RgbColor& color) {}
+    virtual void draw_triangle(const Rect& rect, const RgbColor& color) {}
+    virtual void draw_diamond(const Rect& rect, const RgbColor& color) {}
+    virtual void draw_plus(const Rect& rect, const RgbColor& color) {}
+
+  private:
+    class TextureImpl : public Texture::Impl {
+      public:
+        TextureImpl(pn::string_view name, Size size) : _name(name.copy()), _size(size) {}
+
+        virtual pn::string_view name() const { return _name; }
+        virtual void            draw(const Rect& draw_rect) const {}
+        virtual void draw_cropped(
+                const Rect& dest, const Rect& source, const RgbColor& tint) const {}
+        virtual void draw_shaded(const Rect& draw_rect, const RgbColor& tint) const {}
+        virtual void draw_static(
+                const Rect& draw_rect, const RgbColor& color, uint8_t frac) const {}
+        virtual void draw_outlined(
+                const Rect& draw_rect, const RgbColor& outline_color,
+                const RgbColor& fill_color) const {}
+        virtual const Size& size() const { return _size; }
+
+      private:
+        pn::string _name;
+        Size       _size;
+    };
+
+    class TextureAtlasImpl : public TextureAtlas::Impl {
+      public:
+        virtual Texture texture(pn::string_view name, const Rect& region, Hue hue) const {
+            return std::unique_ptr<Texture::Impl>(new TextureImpl(name, region.size()));
+        }
+    };
+
+    virtual void batch_point(const Point& at, const RgbColor& color) {}
+    virtual void batch_line(const Point& from, const Point& to, const RgbColor& color) {}
+    virtual void batch_rect(const Rect& rect, const RgbColor& color) {}
+};
+
+}  // namespace
+
+class Simulation::Drivers {
+  public:
+    NullPrefsDriver     prefs;
+    NullSoundDriver     sound;
+    HeadlessVideoDriver video;
+};
+
+Simulation::Simulation(std::shared_ptr<ScenarioData> scenario) : _drivers(new Drivers) {
+    init_globals();
+    sys_init();
+    Label::init();
+    Messages::init();
+    InstrumentInit();
+    SpriteHandlingInit();
+    PluginInit(sfz::nullopt, std::move(scenario));
+    SpaceObjectHandlingInit();  // MUST be after PluginInit()
+    Admiral::init();
+    Vectors::init();
+}
+
+Simulation::~Simulation() {}
+
+void Simulation::load_level(pn::string_view name, int32_t seed) {
+    const Level* level = Level::get(name);
+    if (!level) {
+        throw std::runtime_error(pn::format("{0}: no such level", name).c_str());
+    }
+    for (auto& keys : _keys) {
+        keys = sfz::nullopt;
+    }
+
+    g.random.seed = seed;
+    RemoveAllSpaceObjects();
+    g.game_over = false;
+    LoadState s = start_construct_level(*level);
+    while (!s.done) {
+        construct_level(&s);
+    }
+    set_up_instruments();
+    CheckLevelConditions();
+}
+
+ticks Simulation::step(ticks n) {
+    ticks elapsed = ticks(0);
+    while ((elapsed < n) && !done()) {
+        ticks units       = n - elapsed;
+        ticks minor_ticks = g.time.time_since_epoch() % kMajorTick;
+        if (minor_ticks + units > kMajorTick) {
+            units = kMajorTick - minor_ticks;
+        }
+
+        advance_world(units, [this] { apply_inputs(); });
+
+        // The parts of GamePlay's per-tick upkeep that the simulation depends on: the radar sets
+        // the scale that positions are measured against when there is no player ship, and culling
+        // frees vector and sprite slots for reuse.
+        UpdateRadar(units);
+        Vectors::cull();
+        CullSprites();
+
+        elapsed += units;
+    }
+    return elapsed;
+}
+
+void Simulation::apply_input(Handle<Admiral> admiral, uint32_t keys) {
+    _keys[admiral.number()] = keys;
+}
+
+void Simulation::release_input(Handle<Admiral> admiral) { _keys[admiral.number()] = sfz::nullopt; }
+
+void Simulation::apply_inputs() {
+    for (Handle<Admiral> a : Admiral::all()) {
+        const sfz::optional<uint32_t>& keys     = _keys[a.number()];
+        Handle<SpaceObject>            flagship = a->flagship();
+        if (!keys.has_value() || !flagship.get() || (flagship->active != kObjectInUse)) {
+            continue;
+        }
+        if (flagship->attributes & kIsPlayerShip) {
+            flagship->keysDown = *keys & ~g.key_mask;
+        } else {
+            flagship->keysDown =
+                    (flagship->keysDown & kSpecialKeyMask) | *keys | kManualOverrideFlag;
+        }
+    }
+}
+
+SimulationState Simulation::read_state() const {
+    return SimulationState{
+            g.time,
+            g.game_over,
+            g.victor,
+            {g.admirals.get(), Admiral::all().size()},
+            {g.destinations.get(), Destination::all().size()},
+            {g.objects.get(), SpaceObject::all().size()},
+            {g.vectors.get(), Vector::all().size()},
+    };
+}
+
+bool Simulation::done() const { return g.game_over && (g.time >= g.game_over_at); }
+
+}  // namespace antares
@@ -0,0 +1,131 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "sim/simulation.hpp"
+
+#include <gmock/gmock.h>
+#include <map>
+#include <sfz/sfz.hpp>
+#include <thread>
+
+#include "config/keys.hpp"
+#include "data/plugin.hpp"
+#include "game/state-dump.hpp"
+
+using sfz::dec;
+using testing::Eq;
+using testing::Ne;
+
+namespace antares {
+namespace {
+
+using SimulationTest = testing::Test;
+
+const int32_t kSeed = 0x1234;
+
+// The level for chapter 1 of the factory scenario.
+pn::string_view first_level() { return plug.data->chapters.at(1); }
+
+// Parses the output of dump_state() into a map from each field's path to its value.
+std::map<pn::string, pn::string> dump() {
+    pn::data data;
+    dump_state(data.output());
+    pn::string_view text = data.as_string();
+
+    std::map<pn::string, pn::string> fields;
+    for (size_t start = 0, end; start < text.size(); start = end + 1) {
+        end = text.find("\n", start);
+        if (end == text.npos) {
+            end = text.size();
+        }
+        pn::string_view line = text.substr(start, end - start);
+        size_t          tab  = line.find("\t");
+        if (tab != line.npos) {
+            fields[line.substr(0, tab).copy()] = line.substr(tab + 1).copy();
+        }
+    }
+    return fields;
+}
+
+// Plays the first level for `n` ticks from `seed`, and returns the dump of its final state.
+std::map<pn::string, pn::string> play(ticks n, int32_t seed) {
+    Simulation sim;
+    sim.load_level(first_level(), seed);
+    sim.step(n);
+    return dump();
+}
+
+TEST_F(SimulationTest, ReadStateMatchesDumpState) {
+    Simulation sim;
+    sim.load_level(first_level(), kSeed);
+    EXPECT_THAT(sim.step(ticks(600)), Eq(ticks(600)));
+
+    const SimulationState            state  = sim.read_state();
+    std::map<pn::string, pn::string> fields = dump();
+
+    EXPECT_THAT(
+            fields["global/time"],
+            Eq(pn::dump(int64_t{state.time.time_since_epoch().count()}, pn::dump_short)));
+    EXPECT_THAT(
+            fields["global/game_over"], Eq(pn::string_view{state.game_over ? "true" : "false"}));
+
+    int active = 0;
+    for (size_t i = 0; i < state.objects.size(); ++i) {
+        const SpaceObject& o = state.objects[i];
+        const pn::string   p = pn::format("object/{0}/", dec(i, 3));
+        if (o.active == kObjectAvailable) {
+            EXPECT_THAT(fields.count(pn::format("{0}id", p)), Eq(0u)) << p;
+            continue;
+        }
+        ++active;
+        EXPECT_THAT(fields[pn::format("{0}id", p)], Eq(pn::dump(int64_t{o.id}, pn::dump_short)))
+                << p;
+        EXPECT_THAT(
+                fields[pn::format("{0}location", p)],
+                Eq(pn::format("{0}, {1}", o.location.h, o.location.v)))
+                << p;
+    }
+    EXPECT_THAT(active, Ne(0));
+}
+
+// Each run has its own game state, on its own thread; from the same seed, they must agree.
+TEST_F(SimulationTest, Deterministic) {
+    std::map<pn::string, pn::string> a, b;
+    std::thread                      ta([&a] { a = play(ticks(600), kSeed); });
+    std::thread                      tb([&b] { b = play(ticks(600), kSeed); });
+    ta.join();
+    tb.join();
+    EXPECT_THAT(a, Eq(b));
+    EXPECT_THAT(a.size(), Ne(0u));
+}
+
+TEST_F(SimulationTest, ApplyInput) {
+    Simulation sim;
+    sim.load_level(first_level(), kSeed);
+    sim.step(ticks(1));
+
+    Handle<Admiral>     player(0);
+    Handle<SpaceObject> flagship = player->flagship();
+    ASSERT_THAT(flagship.get(), Ne(nullptr));
+
+    sim.apply_input(player, kUpKey);
+    sim.step(ticks(60));
+    EXPECT_THAT(sim.read_state().objects[flagship].keysDown & kUpKey, Ne(0u));
+}
+
+}  // namespace
+}  // namespace antares
@@ -60,8 +60,9 @@ class NullSound : public Sound {
   public:
     NullSound() {}
 
-    virtual void play(uint8_t volume) {}
-    virtual void loop(uint8_t volume) {}
+    virtual void    play(uint8_t volume) {}
+    virtual void    loop(uint8_t volume) {}
+    virtual int64_t bytes() const { return 0; }
 };
 
 }  // namespace
@@ -121,6 +122,8 @@ class LogSoundDriver::LogSound : public Sound {
     virtual void play(uint8_t volume) { _driver._active_channel->play(_kind, _path, volume); }
     virtual void loop(uint8_t volume) { _driver._active_channel->loop(_kind, _path, volume); }
 
+    virtual int64_t bytes() const { return 0; }
+
   private:
     const LogSoundDriver& _driver;
     const pn::string      _kind;
@@ -229,6 +229,24 @@ void SoundFX::load(pn::string_view id) {
     }
 }
 
+int64_t SoundFX::loaded() const {
+    int64_t count = 0;
+    for (const smartSoundHandle& sound : sounds) {
+        count += (sound.soundHandle != nullptr);
+    }
+    return count;
+}
+
+int64_t SoundFX::bytes() const {
+    int64_t bytes = 0;
+    for (const smartSoundHandle& sound : sounds) {
+        if (sound.soundHandle) {
+            bytes += sound.soundHandle->bytes();
+        }
+    }
+    return bytes;
+}
+
 void SoundFX::stop() {
     for (int i = 0; i < kMaxChannelNum; i++) {
         channels[i].channelPtr->quiet();
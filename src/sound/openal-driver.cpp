@@ -53,20 +53,23 @@ void check_al_error(pn::string_view method) {
 
 class OpenAlSoundDriver::OpenAlSound : public Sound {
   public:
-    OpenAlSound(const OpenAlSoundDriver& driver) : _driver(driver), _buffer(generate_buffer()) {}
+    OpenAlSound(const OpenAlSoundDriver& driver)
+            : _driver(driver), _buffer(generate_buffer()), _bytes(0) {}
 
     ~OpenAlSound() {
         alDeleteBuffers(1, &_buffer);
         alGetError();  // discard.
     }
 
-    virtual void play(uint8_t volume);
-    virtual void loop(uint8_t volume);
+    virtual void    play(uint8_t volume);
+    virtual void    loop(uint8_t volume);
+    virtual int64_t bytes() const { return _bytes; }
 
     void buffer(const SoundData& s) {
         ALenum format = (s.channels == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
         alBufferData(_buffer, format, s.data.data(), s.data.size(), s.frequency);
         check_al_error("alBufferData");
+        _bytes = s.data.size();
     }
 
     ALuint buffer() const { return _buffer; }
@@ -81,6 +84,7 @@ class OpenAlSoundDriver::OpenAlSound : public Sound {
 
     const OpenAlSoundDriver& _driver;
     ALuint                   _buffer;
+    int64_t                  _bytes;
 };
 
 class OpenAlSoundDriver::OpenAlChannel : public SoundChannel {
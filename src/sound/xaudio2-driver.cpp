@@ -174,10 +174,11 @@ void XAudio2SoundDriver::XAudio2SourceVoiceInstance::reset_and_play_sound(
 class XAudio2SoundDriver::XAudio2Sound : public Sound {
   public:
     XAudio2Sound(XAudio2SoundDriver& driver)
-            : _driver(driver), _instance(nullptr) {}
+            : _driver(driver), _instance(nullptr), _bytes(0) {}
 
-    virtual void play(uint8_t volume);
-    virtual void loop(uint8_t volume);
+    virtual void    play(uint8_t volume);
+    virtual void    loop(uint8_t volume);
+    virtual int64_t bytes() const { return _bytes; }
 
     void buffer(const SoundData& s) {
         if (_instance) {
@@ -199,6 +200,7 @@ class XAudio2SoundDriver::XAudio2Sound : public Sound {
         frequency_ratio = std::min(
                 XAUDIO2_MAX_FREQ_RATIO, std::max(XAUDIO2_MIN_FREQ_RATIO, frequency_ratio));
 
+        _bytes    = data.size();
         _instance = new XAudio2SoundInstance(_driver, std::move(data), frequency_ratio);
     }
 
@@ -207,6 +209,7 @@ class XAudio2SoundDriver::XAudio2Sound : public Sound {
   private:
     XAudio2SoundDriver&     _driver;
     XAudio2SoundInstance*   _instance;
+    int64_t                 _bytes;
 };
 
 class XAudio2SoundDriver::XAudio2VoiceCallbacks : public IXAudio2VoiceCallback {
@@ -56,6 +56,20 @@ void EventScheduler::schedule_snapshot(int64_t at) {
     push_heap(_snapshot_times.begin(), _snapshot_times.end(), greater<wall_ticks>());
 }
 
+void EventScheduler::schedule_snapshots(
+        int64_t start, int64_t interval, sfz::optional<int64_t> end) {
+    if (interval <= 0) {
+        throw std::runtime_error("snapshot interval must be positive");
+    } else if (end.has_value() && (*end <= start)) {
+        return;
+    }
+    SnapshotRule rule{wall_ticks(ticks(start)), ticks(interval), sfz::nullopt};
+    if (end.has_value()) {
+        rule.end.emplace(wall_ticks(ticks(*end)));
+    }
+    _snapshot_rules.push_back(rule);
+}
+
 void EventScheduler::schedule_event(unique_ptr<Event> event) {
     _event_heap.emplace_back(std::move(event));
     push_heap(_event_heap.begin(), _event_heap.end(), is_later);
@@ -100,17 +114,44 @@ void EventScheduler::advance_tick_count(EventScheduler::MainLoop& loop, wall_tic
     if (loop.takes_snapshots() && have_snapshots_before(ticks)) {
         loop.draw();
         while (have_snapshots_before(ticks)) {
-            _ticks = _snapshot_times.front();
+            _ticks = pop_snapshot();
             loop.snapshot(_ticks);
-            pop_heap(_snapshot_times.begin(), _snapshot_times.end(), greater<wall_ticks>());
-            _snapshot_times.pop_back();
         }
     }
     _ticks = ticks;
 }
 
 bool EventScheduler::have_snapshots_before(wall_ticks ticks) const {
-    return !_snapshot_times.empty() && (_snapshot_times.front() < ticks);
+    if (!_snapshot_times.empty() && (_snapshot_times.front() < ticks)) {
+        return true;
+    }
+    for (const SnapshotRule& rule : _snapshot_rules) {
+        if (rule.next < ticks) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Removes and returns the earliest snapshot time, from the one-off snapshots or the rules.
+wall_ticks EventScheduler::pop_snapshot() {
+    auto rule = std::min_element(
+            _snapshot_rules.begin(), _snapshot_rules.end(),
+            [](const SnapshotRule& x, const SnapshotRule& y) { return x.next < y.next; });
+    if (!_snapshot_times.empty() &&
+        ((rule == _snapshot_rules.end()) || (_snapshot_times.front() <= rule->next))) {
+        const wall_ticks at = _snapshot_times.front();
+        pop_heap(_snapshot_times.begin(), _snapshot_times.end(), greater<wall_ticks>());
+        _snapshot_times.pop_back();
+        return at;
+    }
+
+    const wall_ticks at = rule->next;
+    rule->next += rule->interval;
+    if (rule->end.has_value() && (rule->next >= *rule->end)) {
+        _snapshot_rules.erase(rule);
+    }
+    return at;
 }
 
 bool EventScheduler::is_later(const unique_ptr<Event>& x, const unique_ptr<Event>& y) {
@@ -105,8 +105,9 @@ void Master::become_front() {
         case TITLE_SCREEN_PICT:
             _state = INTRO_SCROLL;
             // TODO(sfiera): prevent the intro screen from displaying on subsequent launches.
-            if (plug.info.intro.has_value()) {
-                stack()->push(new ScrollTextScreen(*plug.info.intro, 450, kSlowScrollInterval));
+            if (plug.data->info.intro.has_value()) {
+                stack()->push(
+                        new ScrollTextScreen(*plug.data->info.intro, 450, kSlowScrollInterval));
                 break;
             }
             [[clang::fallthrough]];
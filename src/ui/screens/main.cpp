@@ -55,7 +55,7 @@ MainScreen::MainScreen()
     button(kSoloButton)
             ->bind({
                     [this] { stack()->push(new SoloGame); },
-                    [] { return plug.chapters.find(1) != plug.chapters.end(); },
+                    [] { return plug.data->chapters.find(1) != plug.data->chapters.end(); },
             });
 
     button(kNetButton)
@@ -68,9 +68,10 @@ MainScreen::MainScreen()
             ->bind({
                     [this] {
                         stack()->push(new ScrollTextScreen(
-                                *plug.info.intro, kTitleTextScrollWidth, kSlowScrollInterval));
+                                *plug.data->info.intro, kTitleTextScrollWidth,
+                                kSlowScrollInterval));
                     },
-                    [] { return plug.info.intro.has_value(); },
+                    [] { return plug.data->info.intro.has_value(); },
             });
 
     button(kDemoButton)
@@ -84,10 +85,10 @@ MainScreen::MainScreen()
     button(kAboutButton)
             ->bind({
                     [this] {
-                        stack()->push(
-                                new ScrollTextScreen(*plug.info.about, 540, kFastScrollInterval));
+                        stack()->push(new ScrollTextScreen(
+                                *plug.data->info.about, 540, kFastScrollInterval));
                     },
-                    [] { return plug.info.about.has_value(); },
+                    [] { return plug.data->info.about.has_value(); },
             });
 
     button(kOptionsButton)
@@ -120,7 +121,7 @@ void MainScreen::become_front() {
 }
 
 bool MainScreen::next_timer(wall_time& time) {
-    if (_replays.size() || plug.info.intro.has_value()) {
+    if (_replays.size() || plug.data->info.intro.has_value()) {
         time = _next_timer;
         return true;
     }
@@ -129,14 +130,14 @@ bool MainScreen::next_timer(wall_time& time) {
 
 void MainScreen::fire_timer() {
     Randomize(1);
-    int option_count = _replays.size() + (plug.info.intro.has_value() ? 1 : 0);
+    int option_count = _replays.size() + (plug.data->info.intro.has_value() ? 1 : 0);
     if (option_count == 0) {
         return;
     }
     int option = rand() % option_count;
     if (option == _replays.size()) {
         stack()->push(new ScrollTextScreen(
-                *plug.info.intro, kTitleTextScrollWidth, kSlowScrollInterval));
+                *plug.data->info.intro, kTitleTextScrollWidth, kSlowScrollInterval));
     } else {
         stack()->push(new ReplayGame(_replays[option]));
     }
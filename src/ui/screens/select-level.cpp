@@ -118,7 +118,7 @@ void SelectLevelScreen::key_down(const KeyDownEvent& event) {
                 case Key::N_TIMES:
                     _state          = UNLOCKING;
                     _unlock_chapter = 0;
-                    _unlock_digits  = ndigits(plug.levels.size());
+                    _unlock_digits  = ndigits(plug.data->levels.size());
                     sys.sound.cloak_on();
                     return;
                 default: break;
@@ -134,7 +134,7 @@ void SelectLevelScreen::key_down(const KeyDownEvent& event) {
             _unlock_chapter = (_unlock_chapter * 10) + digit;
             if (--_unlock_digits == 0) {
                 _state = SELECTING;
-                if (plug.chapters.find(_unlock_chapter) == plug.chapters.end()) {
+                if (plug.data->chapters.find(_unlock_chapter) == plug.data->chapters.end()) {
                     return;
                 }
                 sys.sound.cloak_off();
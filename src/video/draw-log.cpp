@@ -0,0 +1,228 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "video/draw-log.hpp"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+
+namespace antares {
+
+namespace {
+
+const uint8_t kMagic[] = {'A', 'D', 'L', '1'};
+
+struct DrawOpInfo {
+    const char* name;
+    const char* args;  // 'i' for integer, 'c' for color, 'n' for name.
+};
+
+const DrawOpInfo kDrawOps[] = {
+        {nullptr, nullptr},
+        {"draw", "iiiin"},
+        {"crop", "iiiiiicn"},
+        {"crop", "iiiiiiiicn"},
+        {"tint", "iiiicn"},
+        {"static", "iiiicin"},
+        {"outline", "iiiiccn"},
+        {"rect", "iiiic"},
+        {"dither", "iiiic"},
+        {"point", "iic"},
+        {"line", "iiiic"},
+        {"triangle", "iiiic"},
+        {"diamond", "iiiic"},
+        {"plus", "iiiic"},
+};
+const size_t kDrawOpCount = sizeof(kDrawOps) / sizeof(kDrawOps[0]);
+
+int64_t unzigzag(uint64_t u) {
+    return static_cast<int64_t>(u >> 1) ^ -static_cast<int64_t>(u & 1);
+}
+
+class DrawLogReader {
+  public:
+    DrawLogReader(const uint8_t* begin, const uint8_t* end) : _p(begin), _end(end) {}
+
+    bool done() const { return _p == _end; }
+
+    uint64_t varint() {
+        uint64_t u = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (_p == _end) {
+                throw std::runtime_error("draw log: truncated varint");
+            }
+            uint8_t byte = *(_p++);
+            u |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return u;
+            }
+        }
+        throw std::runtime_error("draw log: varint too long");
+    }
+
+    pn::string_view bytes(uint64_t size) {
+        if (size > static_cast<uint64_t>(_end - _p)) {
+            throw std::runtime_error("draw log: truncated string");
+        }
+        pn::string_view s(reinterpret_cast<const char*>(_p), size);
+        _p += size;
+        return s;
+    }
+
+  private:
+    const uint8_t* _p;
+    const uint8_t* _end;
+};
+
+}  // namespace
+
+void TextDrawLog::begin(DrawOp op) {
+    pn::string_view command = kDrawOps[static_cast<size_t>(op)].name;
+    _args.clear();
+    _new_command = _last_args.empty() || (command != last(0));
+    add(command);
+}
+
+void TextDrawLog::arg(int64_t i) {
+    char s[21];
+    arg(pn::string_view(s, snprintf(s, sizeof(s), "%" PRId64, i)));
+}
+
+void TextDrawLog::arg(RgbColor color) {
+    char s[9];
+    if (color.alpha != 255) {
+        snprintf(s, 9, "%02x%02x%02x%02x", color.red, color.green, color.blue, color.alpha);
+    } else {
+        snprintf(s, 9, "%02x%02x%02x", color.red, color.green, color.blue);
+    }
+    arg(pn::string_view{s});
+}
+
+void TextDrawLog::arg(pn::string_view s) {
+    _log += "\t";
+    add(s);
+}
+
+void TextDrawLog::end() {
+    _log += "\n";
+    using std::swap;
+    swap(_args, _last_args);
+}
+
+void TextDrawLog::clear() {
+    _log.clear();
+    _args.clear();
+    _last_args.clear();
+}
+
+void TextDrawLog::add(pn::string_view s) {
+    size_t index = _args.size();
+    if (!_new_command && (index < _last_args.size()) && (s == last(index))) {
+        _args.push_back(_last_args[index]);
+        return;
+    }
+    size_t start = _log.size();
+    _log += s;
+    _args.push_back(std::make_pair(start, _log.size() - start));
+}
+
+pn::string_view TextDrawLog::last(size_t index) const {
+    return _log.substr(_last_args[index].first, _last_args[index].second);
+}
+
+BinaryDrawLog::BinaryDrawLog() { clear(); }
+
+void BinaryDrawLog::arg(RgbColor color) {
+    varint((static_cast<uint32_t>(255 - color.alpha) << 24) | (color.red << 16) |
+           (color.green << 8) | color.blue);
+}
+
+void BinaryDrawLog::arg(const DrawLogName& name) {
+    if (name.id >= _defined.size()) {
+        _defined.resize(name.id + 1, 0);
+    }
+    if (_defined[name.id] == _generation) {
+        varint(static_cast<uint64_t>(name.id) << 1);
+        return;
+    }
+    _defined[name.id] = _generation;
+    varint((static_cast<uint64_t>(name.id) << 1) | 1);
+    varint(name.name.size());
+    _data.insert(_data.end(), name.name.data(), name.name.data() + name.name.size());
+}
+
+void BinaryDrawLog::clear() {
+    _data.assign(std::begin(kMagic), std::end(kMagic));
+    ++_generation;
+}
+
+pn::data_view BinaryDrawLog::data() const {
+    return pn::data_view{_data.data(), static_cast<int>(_data.size())};
+}
+
+void BinaryDrawLog::varint(uint64_t u) {
+    while (u >= 0x80) {
+        _data.push_back((u & 0x7f) | 0x80);
+        u >>= 7;
+    }
+    _data.push_back(u);
+}
+
+pn::string decode_draw_log(pn::data_view data) {
+    if ((static_cast<size_t>(data.size()) < sizeof(kMagic)) ||
+        !std::equal(std::begin(kMagic), std::end(kMagic), data.data())) {
+        throw std::runtime_error("draw log: bad magic number");
+    }
+    DrawLogReader in{data.data() + sizeof(kMagic), data.data() + data.size()};
+    TextDrawLog   out;
+
+    std::map<uint64_t, pn::string_view> names;
+    while (!in.done()) {
+        uint64_t op = in.varint();
+        if ((op == 0) || (op >= kDrawOpCount)) {
+            throw std::runtime_error("draw log: unknown command");
+        }
+
+        out.begin(static_cast<DrawOp>(op));
+        for (const char* arg = kDrawOps[op].args; *arg; ++arg) {
+            uint64_t u = in.varint();
+            switch (*arg) {
+                case 'i': out.arg(unzigzag(u)); break;
+                case 'c': out.arg(rgba(u >> 16, u >> 8, u, 255 - (u >> 24))); break;
+                case 'n': {
+                    if (u & 1) {
+                        names[u >> 1] = in.bytes(in.varint());
+                    }
+                    auto it = names.find(u >> 1);
+                    if (it == names.end()) {
+                        throw std::runtime_error("draw log: undefined name");
+                    }
+                    out.arg(it->second);
+                    break;
+                }
+            }
+        }
+        out.end();
+    }
+    return out.text().copy();
+}
+
+}  // namespace antares
@@ -0,0 +1,115 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+
+#include "video/draw-log.hpp"
+
+#include <gmock/gmock.h>
+#include <stdexcept>
+
+using testing::Eq;
+
+namespace antares {
+namespace {
+
+using DrawLogTest = testing::Test;
+
+template <typename Log>
+void args(Log*) {}
+
+template <typename Log, typename T, typename... Rest>
+void args(Log* log, const T& arg, const Rest&... rest) {
+    log->arg(arg);
+    args(log, rest...);
+}
+
+template <typename Log, typename... Args>
+void command(Log* log, DrawOp op, const Args&... a) {
+    log->begin(op);
+    args(log, a...);
+    log->end();
+}
+
+// Logs each command at least once, with repeated commands and arguments, names used more than
+// once, and integers and colors of varying encoded lengths.
+template <typename Log>
+void draw(Log* log) {
+    const DrawLogName ship{3, "/sprites/ships/ship%0"};
+    const DrawLogName beam{7, "/sprites/beam%12"};
+    const DrawLogName font{300, "/fonts/tactical%65"};
+    command(log, DrawOp::DRAW, 10, 20, 42, 52, ship);
+    command(log, DrawOp::DRAW, 10, 30, 42, 62, ship);
+    command(log, DrawOp::DRAW, 10, 30, 42, 62, beam);
+    command(log, DrawOp::CROP, 0, 0, 8, 12, 100, 200, RgbColor::white(), font);
+    command(log, DrawOp::CROP_SCALED, 0, 0, 8, 12, 1, 2, 16, 24, rgb(255, 128, 0), font);
+    command(log, DrawOp::TINT, -5, -6, 27, 26, rgb(255, 128, 0), beam);
+    command(log, DrawOp::STATIC, 0, 0, 32, 32, rgba(1, 2, 3, 4), 3, ship);
+    command(log, DrawOp::OUTLINE, 0, 0, 32, 32, RgbColor::black(), rgba(0, 0, 0, 128), ship);
+    command(log, DrawOp::RECT, 0, 0, 640, 480, RgbColor::clear());
+    command(log, DrawOp::DITHER, 0, 0, 640, 480, rgba(0, 0, 0, 64));
+    command(log, DrawOp::POINT, int64_t{1} << 40, -(int64_t{1} << 40), RgbColor::white());
+    command(log, DrawOp::POINT, 0, -1, RgbColor::white());
+    command(log, DrawOp::LINE, -1, -1, 1, 1, rgb(0, 255, 0));
+    command(log, DrawOp::TRIANGLE, 4, 4, 12, 12, rgb(0, 255, 0));
+    command(log, DrawOp::DIAMOND, 4, 4, 12, 12, rgb(0, 0, 255));
+    command(log, DrawOp::PLUS, 4, 4, 12, 12, rgb(0, 0, 255));
+}
+
+TEST_F(DrawLogTest, RoundTrip) {
+    TextDrawLog text;
+    draw(&text);
+    BinaryDrawLog binary;
+    draw(&binary);
+    EXPECT_THAT(decode_draw_log(binary.data()), Eq(text.text()));
+}
+
+// After clear(), each log starts over; in particular, names are defined again on first use.
+TEST_F(DrawLogTest, Clear) {
+    TextDrawLog text;
+    draw(&text);
+    const pn::string expected = text.text().copy();
+    text.clear();
+    draw(&text);
+    EXPECT_THAT(text.text(), Eq(expected));
+
+    BinaryDrawLog binary;
+    draw(&binary);
+    binary.clear();
+    draw(&binary);
+    EXPECT_THAT(decode_draw_log(binary.data()), Eq(expected));
+}
+
+TEST_F(DrawLogTest, Malformed) {
+    const uint8_t bad_magic[] = {'A', 'D', 'L', '0'};
+    EXPECT_THROW(decode_draw_log(pn::data_view{bad_magic, 4}), std::runtime_error);
+
+    BinaryDrawLog binary;
+    draw(&binary);
+    const pn::data_view data = binary.data();
+    EXPECT_THROW(
+            decode_draw_log(pn::data_view{data.data(), data.size() - 1}), std::runtime_error);
+
+    const uint8_t unknown[] = {'A', 'D', 'L', '1', 99};
+    EXPECT_THROW(decode_draw_log(pn::data_view{unknown, 5}), std::runtime_error);
+
+    // Name 1 is used without being defined.
+    const uint8_t undefined[] = {'A', 'D', 'L', '1', 1, 0, 0, 0, 0, 2};
+    EXPECT_THROW(decode_draw_log(pn::data_view{undefined, 10}), std::runtime_error);
+}
+
+}  // namespace
+}  // namespace antares
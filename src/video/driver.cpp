@@ -18,6 +18,7 @@
 
 #include "video/driver.hpp"
 
+#include "drawing/pix-map.hpp"
 #include "game/sys.hpp"
 #include "lang/defines.hpp"
 
@@ -32,8 +33,59 @@ VideoDriver::VideoDriver() {
 
 VideoDriver::~VideoDriver() { sys.video = NULL; }
 
+namespace {
+
+class SeparateTextureAtlas : public TextureAtlas::Impl {
+  public:
+    SeparateTextureAtlas(VideoDriver& driver, VideoDriver::AtlasLoader load)
+            : _driver(driver), _load(std::move(load)) {}
+
+    virtual Texture texture(pn::string_view name, const Rect& region, Hue hue) const {
+        ArrayPixMap pix(region.size());
+        ArrayPixMap overlay(region.size());
+        _load(region, &pix, &overlay);
+        if (hue != Hue::GRAY) {
+            tint_overlay(&pix, overlay, hue);
+        }
+        return _driver.texture(name, pix, 1);
+    }
+
+  private:
+    VideoDriver&                   _driver;
+    const VideoDriver::AtlasLoader _load;
+};
+
+}  // namespace
+
+TextureAtlas VideoDriver::atlas(Size size, AtlasLoader load) {
+    return std::unique_ptr<TextureAtlas::Impl>(new SeparateTextureAtlas(*this, std::move(load)));
+}
+
+void VideoDriver::draw_sprites(const std::vector<SpriteInstance>& sprites) {
+    for (const SpriteInstance& sprite : sprites) {
+        if (sprite.is_static) {
+            sprite.texture->draw_static(sprite.rect, sprite.color, sprite.frac);
+        } else {
+            sprite.texture->draw(sprite.rect);
+        }
+    }
+}
+
+void VideoDriver::draw_icons(const std::vector<IconInstance>& icons) {
+    for (const IconInstance& icon : icons) {
+        switch (icon.shape) {
+            case IconInstance::SQUARE: Rects().fill(icon.rect, icon.color); break;
+            case IconInstance::TRIANGLE: draw_triangle(icon.rect, icon.color); break;
+            case IconInstance::DIAMOND: draw_diamond(icon.rect, icon.color); break;
+            case IconInstance::PLUS: draw_plus(icon.rect, icon.color); break;
+        }
+    }
+}
+
 Texture::Impl::~Impl() {}
 
+TextureAtlas::Impl::~Impl() {}
+
 TextReceiver::~TextReceiver() { sys.video->stop_editing(this); }
 
 Points::Points() { sys.video->begin_points(); }
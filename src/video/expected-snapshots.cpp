@@ -0,0 +1,209 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "video/expected-snapshots.hpp"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <pn/input>
+#include <pn/output>
+#include <vector>
+
+using sfz::mapped_file;
+using sfz::range;
+
+namespace path = sfz::path;
+
+namespace antares {
+
+namespace {
+
+// Lists the files below `root`/screens, relative to `root`.
+class GoldenLister : public sfz::TreeWalker {
+  public:
+    GoldenLister(pn::string_view root, std::vector<pn::string>* relpaths)
+            : _root_size(root.size()), _relpaths(relpaths) {}
+
+    void file(pn::string_view name, const sfz::Stat& st) const override {
+        pn::string_view relpath = name.substr(_root_size + 1);
+        pn::string_view prefix  = "screens/";
+        if ((relpath.size() > prefix.size()) && (relpath.substr(0, prefix.size()) == prefix)) {
+            _relpaths->push_back(relpath.copy());
+        }
+    }
+
+    void pre_directory(pn::string_view name, const sfz::Stat& st) const override {}
+    void cycle_directory(pn::string_view name, const sfz::Stat& st) const override {}
+    void post_directory(pn::string_view name, const sfz::Stat& st) const override {}
+    void symlink(pn::string_view name, const sfz::Stat& st) const override {}
+    void broken_symlink(pn::string_view name, const sfz::Stat& st) const override {}
+    void other(pn::string_view name, const sfz::Stat& st) const override {}
+
+  private:
+    const int                _root_size;
+    std::vector<pn::string>* _relpaths;
+};
+
+bool matches(const RgbColor& expected, const RgbColor& actual, int tolerance) {
+    return (std::abs(expected.red - actual.red) <= tolerance) &&
+           (std::abs(expected.green - actual.green) <= tolerance) &&
+           (std::abs(expected.blue - actual.blue) <= tolerance) &&
+           (std::abs(expected.alpha - actual.alpha) <= tolerance);
+}
+
+int64_t count_differences(const PixMap& expected, const PixMap& actual, int tolerance) {
+    int64_t count = 0;
+    for (int32_t y : range(expected.size().height)) {
+        const RgbColor* e = expected.row(y);
+        const RgbColor* a = actual.row(y);
+        for (int32_t x : range(expected.size().width)) {
+            count += !matches(e[x], a[x], tolerance);
+        }
+    }
+    return count;
+}
+
+// Whether text matches its golden, which may have "\r\n" line endings where the text has "\n", as
+// in a checkout with core.autocrlf set.
+bool text_matches(pn::data_view golden, pn::data_view actual) {
+    const uint8_t* g     = golden.data();
+    const uint8_t* g_end = g + golden.size();
+    const uint8_t* a     = actual.data();
+    const uint8_t* a_end = a + actual.size();
+    for (; (g != g_end) && (a != a_end); ++g, ++a) {
+        if ((*g == '\r') && (*a == '\n') && ((g + 1) != g_end) && (g[1] == '\n')) {
+            ++g;
+        }
+        if (*g != *a) {
+            return false;
+        }
+    }
+    return (g == g_end) && (a == a_end);
+}
+
+// Where two images differ, in red over a dimmed copy of `expected`.
+ArrayPixMap diff_image(const PixMap& expected, const PixMap& actual, int tolerance) {
+    ArrayPixMap diff(expected.size());
+    for (int32_t y : range(expected.size().height)) {
+        const RgbColor* e = expected.row(y);
+        const RgbColor* a = actual.row(y);
+        RgbColor*       d = diff.mutable_row(y);
+        for (int32_t x : range(expected.size().width)) {
+            if (matches(e[x], a[x], tolerance)) {
+                d[x] = rgb(e[x].red / 4, e[x].green / 4, e[x].blue / 4);
+            } else {
+                d[x] = rgb(255, 0, 0);
+            }
+        }
+    }
+    return diff;
+}
+
+}  // namespace
+
+ExpectedSnapshots::ExpectedSnapshots(
+        pn::string_view dir, const sfz::optional<pn::string>& output_dir, bool keep_going,
+        int tolerance)
+        : _dir(dir.copy()), _keep_going(keep_going), _tolerance(tolerance) {
+    if (output_dir.has_value()) {
+        _output_dir.emplace(output_dir->copy());
+    }
+}
+
+// The golden has to be read either way, so comparing the bytes directly costs no more than
+// comparing digests. Sizes can't be compared first, as a golden with "\r\n" line endings is
+// longer than text that matches it.
+void ExpectedSnapshots::check(pn::string_view relpath, pn::data_view data) {
+    _taken.insert(relpath.copy());
+    pn::string path = pn::format("{0}/{1}", _dir, relpath);
+    if (!path::isfile(path)) {
+        mismatch(relpath, "not expected");
+        write(relpath, data);
+        return;
+    }
+    mapped_file golden(path);
+    if (!text_matches(golden.data(), data)) {
+        mismatch(relpath, "doesn't match expected");
+        write(relpath, data);
+    }
+}
+
+void ExpectedSnapshots::check(pn::string_view relpath, const PixMap& pix) {
+    _taken.insert(relpath.copy());
+    pn::string path = pn::format("{0}/{1}", _dir, relpath);
+    if (!path::isfile(path)) {
+        mismatch(relpath, "not expected");
+    } else {
+        pn::input   in{path, pn::binary};
+        ArrayPixMap golden = read_png(in);
+        if (golden.size() != pix.size()) {
+            mismatch(relpath, "size doesn't match expected");
+        } else {
+            int64_t differ = count_differences(golden, pix, _tolerance);
+            if (!differ) {
+                return;
+            }
+            mismatch(relpath, pn::format("{0} pixels don't match expected", differ));
+
+            pn::data diff;
+            diff_image(golden, pix, _tolerance).encode(diff.output());
+            pn::string_view stem = relpath.substr(0, relpath.size() - 4);  // without ".png"
+            write(pn::format("{0}.diff.png", stem), diff);
+        }
+    }
+
+    ArrayPixMap actual(pix.size());
+    actual.copy(pix);
+    pn::data png;
+    actual.encode(png.output());
+    write(relpath, png);
+}
+
+void ExpectedSnapshots::finish() {
+    std::vector<pn::string> goldens;
+    sfz::walk(_dir, sfz::WALK_PHYSICAL, GoldenLister(_dir, &goldens));
+    std::sort(goldens.begin(), goldens.end());
+    for (const pn::string& relpath : goldens) {
+        if (!_taken.count(relpath)) {
+            mismatch(relpath, "expected, but not taken");
+        }
+    }
+    if (_mismatches) {
+        throw std::runtime_error(
+                pn::format("{0} snapshots didn't match {1}", _mismatches, _dir).c_str());
+    }
+}
+
+void ExpectedSnapshots::mismatch(pn::string_view relpath, pn::string_view reason) {
+    if (!_keep_going) {
+        throw std::runtime_error(pn::format("{0}: {1}", relpath, reason).c_str());
+    }
+    pn::err.format("{0}: {1}\n", relpath, reason);
+    ++_mismatches;
+}
+
+void ExpectedSnapshots::write(pn::string_view relpath, pn::data_view data) {
+    if (!_output_dir.has_value()) {
+        return;
+    }
+    pn::string path = pn::format("{0}/{1}", *_output_dir, relpath);
+    sfz::makedirs(path::dirname(path), 0755);
+    pn::output out{path, pn::binary};
+    out.write(data);
+}
+
+}  // namespace antares
@@ -32,20 +32,24 @@ in vec4 color;
 in vec2 screen_position;
 
 uniform int scale;
-uniform int color_mode;
 uniform sampler2DRect sprite;
 uniform sampler2D static_image;
 uniform float     static_fraction;
 uniform vec2 unit;
 uniform vec4 outline_color;
+uniform vec4 outline_bounds;
 uniform int  seed;
+uniform int       tint;
+uniform int       overlay_offset;
+uniform sampler2D palette;
 
-const int FILL_MODE           = 0;
-const int DITHER_MODE         = 1;
-const int DRAW_SPRITE_MODE    = 2;
-const int TINT_SPRITE_MODE    = 3;
-const int STATIC_SPRITE_MODE  = 4;
-const int OUTLINE_SPRITE_MODE = 5;
+// COLOR_MODE is defined to one of these by the driver, which compiles a program for each.
+#define FILL_MODE           0
+#define DITHER_MODE         1
+#define DRAW_SPRITE_MODE    2
+#define TINT_SPRITE_MODE    3
+#define STATIC_SPRITE_MODE  4
+#define OUTLINE_SPRITE_MODE 5
 
 vec3 pow3(vec3 v, float exp) {
     return vec3(pow(v.x, exp), pow(v.y, exp), pow(v.z, exp));
@@ -68,43 +72,66 @@ vec3 apple_rgb_to_srgb(vec3 apple_rgb_color) {
     return min(vec3(1), max(linear_section, exp_section));
 }
 
+float outline_alpha(vec2 at) {
+    return texture2DRect(sprite, clamp(at, outline_bounds.xy, outline_bounds.zw)).w;
+}
+
+// Colors are converted from Apple RGB to sRGB before they get here, as they are streamed, set or
+// uploaded; see apple_rgb_to_srgb() in drawing/color.cpp. The exception is a sprite partly
+// covered by its tinted overlay, which is mixed unconverted and converted here.
 void main() {
+#if COLOR_MODE == FILL_MODE
+    frag_color = color;
+#elif COLOR_MODE == DITHER_MODE
+    frag_color = color;
+    frag_color.a /= 2.0;
+#else
     vec4 sprite_color = texture2DRect(sprite, uv);
-    if (color_mode == FILL_MODE) {
-        frag_color = color;
-    } else if (color_mode == DITHER_MODE) {
-        frag_color = color;
-        frag_color.a /= 2.0;
-    } else if (color_mode == DRAW_SPRITE_MODE) {
-        frag_color = sprite_color;
-    } else if (color_mode == TINT_SPRITE_MODE) {
-        frag_color = color * sprite_color;
-    } else if (color_mode == STATIC_SPRITE_MODE) {
-        float f            = float(scale) / 256.0;
-        vec2  uv2          = (screen_position + vec2(float(seed) * f, float(seed))) * vec2(f, f);
-        vec4  static_color = texture2D(static_image, uv2).rrrg;
-        if (static_color.w <= static_fraction) {
-            vec4 sprite_alpha = vec4(1, 1, 1, sprite_color.w);
-            frag_color        = color * sprite_alpha;
-        } else {
-            frag_color = sprite_color;
-        }
-    } else if (color_mode == OUTLINE_SPRITE_MODE) {
-        float neighborhood = texture2DRect(sprite, uv + vec2(-unit.s, -unit.t)).w +
-                             texture2DRect(sprite, uv + vec2(-unit.s, 0)).w +
-                             texture2DRect(sprite, uv + vec2(-unit.s, unit.t)).w +
-                             texture2DRect(sprite, uv + vec2(0, -unit.t)).w +
-                             texture2DRect(sprite, uv + vec2(0, unit.t)).w +
-                             texture2DRect(sprite, uv + vec2(unit.s, -unit.t)).w +
-                             texture2DRect(sprite, uv + vec2(unit.s, 0)).w +
-                             texture2DRect(sprite, uv + vec2(unit.s, unit.t)).w;
-        if (sprite_color.w > (neighborhood / 8.0)) {
-            frag_color = outline_color;
-        } else if (sprite_color.w > 0.0) {
-            frag_color = color;
-        } else {
-            frag_color = vec4(0, 0, 0, 0);
+    if (tint >= 0) {
+        // The overlay's red channel selects a shade of the hue, and its alpha how much of it
+        // covers the sprite.
+        // Rows 16-31 of the palette, and the page from `2 * overlay_offset` across, are
+        // unconverted.
+        vec4 over  = texture2DRect(sprite, uv + vec2(float(overlay_offset), 0));
+        vec2 shade = vec2((over.r * 255.0 + 0.5) / 256.0, (float(tint) + 0.5) / 32.0);
+        if (over.a >= 1.0) {
+            sprite_color.rgb = texture2D(palette, shade).rgb;
+        } else if (over.a > 0.0) {
+            vec3 image = texture2DRect(sprite, uv + vec2(float(2 * overlay_offset), 0)).rgb;
+            vec3 hue   = texture2D(palette, shade + vec2(0, 0.5)).rgb;
+            sprite_color.rgb = apple_rgb_to_srgb(mix(image, hue, over.a));
         }
     }
-    frag_color.rgb = apple_rgb_to_srgb(frag_color.rgb);
+#if COLOR_MODE == DRAW_SPRITE_MODE
+    frag_color = sprite_color;
+#elif COLOR_MODE == TINT_SPRITE_MODE
+    frag_color = color * sprite_color;
+#elif COLOR_MODE == STATIC_SPRITE_MODE
+    float f            = float(scale) / 256.0;
+    vec2  uv2          = (screen_position + vec2(float(seed) * f, float(seed))) * vec2(f, f);
+    vec4  static_color = texture2D(static_image, uv2).rrrg;
+    if (static_color.w <= static_fraction) {
+        vec4 sprite_alpha = vec4(1, 1, 1, sprite_color.w);
+        frag_color        = color * sprite_alpha;
+    } else {
+        frag_color = sprite_color;
+    }
+#elif COLOR_MODE == OUTLINE_SPRITE_MODE
+    float neighborhood = outline_alpha(uv + vec2(-unit.s, -unit.t)) +
+                         outline_alpha(uv + vec2(-unit.s, 0)) +
+                         outline_alpha(uv + vec2(-unit.s, unit.t)) +
+                         outline_alpha(uv + vec2(0, -unit.t)) +
+                         outline_alpha(uv + vec2(0, unit.t)) +
+                         outline_alpha(uv + vec2(unit.s, -unit.t)) +
+                         outline_alpha(uv + vec2(unit.s, 0)) +
+                         outline_alpha(uv + vec2(unit.s, unit.t));
+    if (sprite_color.w > (neighborhood / 8.0)) {
+        frag_color = outline_color;
+    } else if (sprite_color.w > 0.0) {
+        frag_color = color;
+    } else {
+        frag_color = vec4(0, 0, 0, 0);
+    }
+#endif
+#endif
 }
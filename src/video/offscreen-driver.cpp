@@ -19,15 +19,21 @@
 #include "video/offscreen-driver.hpp"
 
 #include <fcntl.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
 
 #include <algorithm>
+#include <deque>
+#include <functional>
 #include <pn/output>
+#include <thread>
 #include <sfz/sfz.hpp>
 
 #include "config/preferences.hpp"
 #include "drawing/pix-map.hpp"
+#include "drawing/png-writer.hpp"
 #include "game/sys.hpp"
 #include "game/time.hpp"
 #include "math/geometry.hpp"
@@ -62,30 +68,114 @@ namespace antares {
 
 namespace {
 
+// Reads rectangles of the framebuffer back, and passes their pixels to a writer.
+//
+// With pixel buffer objects (GL 2.1 and later), read() only starts a transfer into one of
+// kBuffers buffers, and the pixels are collected when that buffer is next needed, or by finish().
+// By then the transfer has usually completed while the following frames were drawn, so reading
+// back doesn't stall the pipeline. Without them, pixels are read and written immediately.
 class SnapshotBuffer {
   public:
-    SnapshotBuffer() {}
+    typedef std::function<void(pn::string_view relpath, ArrayPixMap pix)> Writer;
+
+    SnapshotBuffer(bool async, Writer write) : _async(async), _write(std::move(write)) {
+        if (_async) {
+            glGenBuffers(kBuffers, _buffers);
+        }
+    }
+    SnapshotBuffer(const SnapshotBuffer&) = delete;
+    SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+
+    ~SnapshotBuffer() {
+        if (_async) {
+            glDeleteBuffers(kBuffers, _buffers);
+        }
+    }
+
+    void read(Rect bounds, pn::string_view relpath) {
+        const Size size = bounds.size();
+        if (!_async) {
+            _data.resize(bounds.area() * 4);
+            glReadPixels(
+                    bounds.left, bounds.top, size.width, size.height, GL_BGRA, GL_UNSIGNED_BYTE,
+                    _data.data());
+            _write(relpath, unpack(_data.data(), size));
+            return;
+        }
 
-    void copy(Rect bounds, ArrayPixMap& pix) {
-        _data.resize(bounds.area() * 4);
-        Size size = bounds.size();
+        if (_pending.size() == size_t{kBuffers}) {
+            collect();
+        }
+        const GLuint buffer = _buffers[_next];
+        _next               = (_next + 1) % kBuffers;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, bounds.area() * 4, nullptr, GL_STREAM_READ);
         glReadPixels(
                 bounds.left, bounds.top, size.width, size.height, GL_BGRA, GL_UNSIGNED_BYTE,
-                _data.data());
-        uint8_t* p = _data.data();
+                nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        _pending.push_back(Pending{buffer, size, relpath.copy()});
+    }
+
+    // Collects every pending read, oldest first.
+    void finish() {
+        while (!_pending.empty()) {
+            collect();
+        }
+    }
+
+  private:
+    static const int kBuffers = 3;
+
+    struct Pending {
+        GLuint     buffer;
+        Size       size;
+        pn::string relpath;
+    };
+
+    void collect() {
+        Pending p = std::move(_pending.front());
+        _pending.pop_front();
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, p.buffer);
+        const void* data = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+        if (!data) {
+            throw std::runtime_error("glMapBuffer() failed");
+        }
+        ArrayPixMap pix = unpack(static_cast<const uint8_t*>(data), p.size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        _write(p.relpath, std::move(pix));
+    }
+
+    // Converts pixels as read back, in BGRA rows from the bottom up, to an opaque pixmap.
+    //
+    // BGRA is RgbColor's ARGB reversed, so each pixel is byte-swapped as a word, then made
+    // opaque. The loop is over plain words, without calls or branches, so that it vectorizes.
+    static ArrayPixMap unpack(const uint8_t* data, Size size) {
+        const RgbColor opaque_color = RgbColor::black();
+        uint32_t       opaque;
+        memcpy(&opaque, &opaque_color, sizeof(opaque));
+
+        ArrayPixMap pix(size);
         for (int32_t y : range(size.height)) {
-            for (int32_t x : range(size.width)) {
-                uint8_t blue  = *(p++);
-                uint8_t green = *(p++);
-                uint8_t red   = *(p++);
-                ++p;
-                pix.set(x, size.height - y - 1, rgb(red, green, blue));
+            const uint32_t* src = reinterpret_cast<const uint32_t*>(data) +
+                                  ((size.height - y - 1) * size.width);
+            uint32_t* dst = reinterpret_cast<uint32_t*>(pix.mutable_row(y));
+            for (int32_t x = 0; x < size.width; ++x) {
+                const uint32_t v = src[x];
+                dst[x] = ((v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24)) |
+                         opaque;
             }
         }
+        return pix;
     }
 
-  private:
-    vector<uint8_t> _data;
+    const bool          _async;
+    const Writer        _write;
+    vector<uint8_t>     _data;
+    GLuint              _buffers[kBuffers];
+    int                 _next = 0;
+    std::deque<Pending> _pending;
 };
 
 void gl_check() {
@@ -126,14 +216,27 @@ class OffscreenVideoDriver::MainLoop : public EventScheduler::MainLoop {
             Card* initial)
             : _driver(driver),
               _offscreen(driver.viewport_size(), driver._gl_version),
+              _buffer(driver._gl_version >= std::make_pair(2, 1),
+                      [this](pn::string_view relpath, ArrayPixMap pix) {
+                          write(relpath, std::move(pix));
+                      }),
               _setup(*this),
               _loop(driver, initial) {
         if (output_dir.has_value()) {
             _output_dir.emplace(output_dir->copy());
         }
+        if (output_dir.has_value() && !driver._video && !driver._expected) {
+            int threads = driver._png_threads;
+            if (threads <= 0) {
+                threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+            }
+            _png.reset(new PngWriter(threads, threads * 2, driver._png_options));
+        }
     }
 
-    bool takes_snapshots() { return _output_dir.has_value(); }
+    bool takes_snapshots() {
+        return _output_dir.has_value() || _driver._video || _driver._expected;
+    }
 
     void snapshot(wall_ticks ticks) {
         snapshot_to(
@@ -152,19 +255,35 @@ class OffscreenVideoDriver::MainLoop : public EventScheduler::MainLoop {
                 bounds.bottom * _driver._scale,
         };
         bounds.offset(0, _driver.viewport_size().height - bounds.height() - bounds.top);
-        ArrayPixMap pix(bounds.size());
-        _buffer.copy(bounds, pix);
-        pn::string path = pn::format("{0}/{1}", *_output_dir, relpath);
-        sfz::makedirs(path::dirname(path), 0755);
-        pn::output out{path, pn::binary};
-        pix.encode(out);
+        _buffer.read(bounds, relpath);
+    }
+
+    // Writes any snapshots still being read back or encoded.
+    void finish() {
+        _buffer.finish();
+        if (_png) {
+            _png->finish();
+        }
     }
 
     void  draw() { _loop.draw(); }
+    void  begin_frame() { _loop.begin_frame(); }
+    void  end_frame() { _loop.end_frame(); }
     bool  done() const { return _loop.done(); }
     Card* top() const { return _loop.top(); }
 
   private:
+    void write(pn::string_view relpath, ArrayPixMap pix) {
+        if (_driver._expected) {
+            _driver._expected->check(relpath, pix);
+            return;
+        } else if (_driver._video) {
+            _driver._video->write(pix);
+            return;
+        }
+        _png->write(pn::format("{0}/{1}", *_output_dir, relpath), std::move(pix));
+    }
+
     const OffscreenVideoDriver& _driver;
     Offscreen                   _offscreen;
     Framebuffer                 _fb;
@@ -183,6 +302,7 @@ class OffscreenVideoDriver::MainLoop : public EventScheduler::MainLoop {
     };
     Setup                       _setup;
     sfz::optional<pn::string>   _output_dir;
+    unique_ptr<PngWriter>       _png;
     OpenGlVideoDriver::MainLoop _loop;
 };
 
@@ -205,10 +325,16 @@ bool OffscreenVideoDriver::start_editing(TextReceiver* text) { return false; }
 
 void OffscreenVideoDriver::stop_editing(TextReceiver* text) {}
 
+unique_ptr<TeeVideoDriver::Output> OffscreenVideoDriver::tee_output() {
+    return unique_ptr<TeeVideoDriver::Output>(
+            new TeeVideoDriver::LoopOutput<MainLoop>(*this, _output_dir));
+}
+
 void OffscreenVideoDriver::loop(Card* initial, EventScheduler& scheduler) {
     _scheduler = &scheduler;
     MainLoop loop(*this, _output_dir, initial);
     _scheduler->loop(loop);
+    loop.finish();
     _scheduler = nullptr;
 }
 
@@ -237,6 +363,7 @@ void OffscreenVideoDriver::capture(vector<pair<unique_ptr<Card>, pn::string>>& p
         loop.snapshot_to(_capture_rect, p.second);
         loop.top()->stack()->pop(loop.top());
     }
+    loop.finish();
 }
 
 }  // namespace antares
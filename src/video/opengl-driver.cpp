@@ -18,10 +18,14 @@
 
 #include "video/opengl-driver.hpp"
 
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <algorithm>
+#include <memory>
 #include <pn/output>
+#include <tuple>
 
 #include "drawing/color.hpp"
 #include "drawing/pix-map.hpp"
@@ -63,26 +67,55 @@ void Uniform<T>::load(int program) {
     location = glGetUniformLocation(program, name);
 }
 
+static bool operator==(vec2 x, vec2 y) { return (x.x == y.x) && (x.y == y.y); }
+static bool operator==(vec4 x, vec4 y) {
+    return (x.x == y.x) && (x.y == y.y) && (x.z == y.z) && (x.w == y.w);
+}
+
+// Records `value` as the uniform's value, returning false if it already was.
+template <typename T>
+static bool update(const Uniform<T>& uniform, T value) {
+    if (uniform.cached && (uniform.value == value)) {
+        return false;
+    }
+    uniform.cached = true;
+    uniform.value  = value;
+    return true;
+}
+
 template <>
 void Uniform<int>::set(int value) const {
-    glUniform1i(location, value);
+    if (update(*this, value)) {
+        glUniform1i(location, value);
+    }
 }
 
 template <>
 void Uniform<float>::set(float value) const {
-    glUniform1f(location, value);
+    if (update(*this, value)) {
+        glUniform1f(location, value);
+    }
 }
 
 template <>
 void Uniform<vec2>::set(vec2 value) const {
-    glUniform2f(location, value.x, value.y);
+    if (update(*this, value)) {
+        glUniform2f(location, value.x, value.y);
+    }
 }
 
 template <>
 void Uniform<vec4>::set(vec4 value) const {
-    glUniform4f(location, value.x, value.y, value.z, value.w);
+    if (update(*this, value)) {
+        glUniform4f(location, value.x, value.y, value.z, value.w);
+    }
 }
 
+static_assert(
+        sizeof(OpenGlVideoDriver::Context::ColorVertex) ==
+                sizeof(OpenGlVideoDriver::Context::SpriteVertex),
+        "vertex formats must be the same size to share a stream");
+
 namespace {
 
 enum {
@@ -171,6 +204,16 @@ static T _gl_check(T t, const char* fn, const char* file, int line) {
     _GL(glVertexAttribPointer, index, size, type, normalized, stride, pointer)
 #define glEnableVertexAttribArray(index) _GL(glEnableVertexAttribArray, index)
 #define glDisableVertexAttribArray(index) _GL(glDisableVertexAttribArray, index)
+#define glBufferSubData(target, offset, size, data) \
+    _GL(glBufferSubData, target, offset, size, data)
+#define glMapBufferRange(target, offset, length, access) \
+    _GLV(glMapBufferRange, target, offset, length, access)
+#define glUnmapBuffer(target) _GLV(glUnmapBuffer, target)
+#define glFenceSync(condition, flags) _GLV(glFenceSync, condition, flags)
+#define glClientWaitSync(sync, flags, timeout) _GLV(glClientWaitSync, sync, flags, timeout)
+#define glDeleteSync(sync) _GL(glDeleteSync, sync)
+#define glGenVertexArrays(n, arrays) _GL(glGenVertexArrays, n, arrays)
+#define glBindVertexArray(array) _GL(glBindVertexArray, array)
 
 #endif  // NDEBUG
 
@@ -193,17 +236,119 @@ void gl_log(GLint object) {
     pn::err.format("object {0} log: {1}\n", object, (const char*)log.get());
 }
 
-class OpenGlTextureImpl : public Texture::Impl {
+// The game's colors are Apple RGB, and are converted to sRGB for display. Every color mode only
+// selects, masks or blends the colors of its vertices, uniforms and textures, so rather than
+// converting each fragment, those are converted with apple_rgb_to_srgb() as they are streamed,
+// set or uploaded. The result matches converting each fragment to within one level per channel,
+// from float rounding, except where TINT_SPRITE_MODE multiplies a vertex color by a texture color
+// and neither is white or black, which the game doesn't draw.
+//
+// Where a tinted overlay partly covers its sprite, the two are mixed in Apple RGB and the result
+// is converted per fragment, from unconverted copies of the page and the palette.
+
+// A GL texture, shared by every OpenGlTextureImpl drawn from it. An atlas page's overlay is
+// uploaded to the right of its image, `overlay_offset()` pixels across. If the overlay partly
+// covers any pixel, an unconverted copy of the image follows, another `overlay_offset()` across.
+//
+// A page made from a copy of its pixels is uploaded immediately, and stays resident. An atlas page
+// is only loaded and uploaded when first bound, and it may be evicted by Context::evict() and
+// loaded again later; its pixels aren't kept in between.
+class OpenGlTexturePage {
   public:
-    OpenGlTextureImpl(
-            pn::string_view name, const PixMap& image, int scale,
-            const OpenGlVideoDriver::Uniforms& uniforms, GLuint vbuf[3])
-            : _name(name.copy()),
-              _size(image.size()),
-              _scale(scale),
-              _uniforms(uniforms),
-              _vbuf(vbuf) {
-        glBindTexture(GL_TEXTURE_RECTANGLE, _texture.id);
+    OpenGlTexturePage(ArrayPixMap image, OpenGlVideoDriver::Context& gl)
+            : _size(image.size()), _overlay_offset(0), _gl(gl) {
+        apple_rgb_to_srgb(&image);
+        upload(image);
+    }
+
+    OpenGlTexturePage(
+            Size size, VideoDriver::AtlasLoader load, OpenGlVideoDriver::Context& gl)
+            : _size(size), _load(std::move(load)), _overlay_offset(size.width), _gl(gl) {
+        _gl.atlas_pages.insert(this);
+    }
+
+    OpenGlTexturePage(const OpenGlTexturePage&) = delete;
+    OpenGlTexturePage& operator=(const OpenGlTexturePage&) = delete;
+
+    ~OpenGlTexturePage() {
+        unload();
+        _gl.atlas_pages.erase(this);
+    }
+
+    int64_t serial() const { return _serial; }
+    int64_t last_drawn() const { return _last_drawn; }
+    int     overlay_offset() const { return _overlay_offset; }
+
+    // Binds the page to unit 0, uploading it first if needed. Returns false if it is not resident,
+    // and no more pages may be uploaded in this frame.
+    bool bind() {
+        if (!_id) {
+            if (_gl.max_uploads && (_gl.uploads >= _gl.max_uploads)) {
+                return false;
+            }
+            ArrayPixMap image(_size);
+            ArrayPixMap overlay(_size);
+            _load(Rect(Point{0, 0}, _size), &image, &overlay);
+            _panels = partly_covered(overlay) ? 3 : 2;
+            ArrayPixMap pix(_size.width * _panels, _size.height);
+            if (_panels == 3) {
+                pix.view(panel(2)).copy(image);
+            }
+            apple_rgb_to_srgb(&image);  // but not `overlay`, whose red channel is a shade.
+            pix.view(panel(0)).copy(image);
+            pix.view(panel(1)).copy(overlay);
+            upload(pix);
+            ++_gl.uploads;
+            ++_gl.stats.page_uploads;
+            _gl.resident_bytes += bytes();
+            _last_drawn = _gl.stats.frames;
+            _gl.evict();
+        }
+        _last_drawn = _gl.stats.frames;
+        _gl.bind_texture(_id);
+        return true;
+    }
+
+    // Whether Context::evict() may unload the page.
+    bool evictable() const { return _load && _id && (_last_drawn < _gl.stats.frames); }
+
+    void unload() {
+        if (!_id) {
+            return;
+        }
+        if (_gl.bound_texture == _id) {
+            _gl.bound_texture = 0;  // deleting a bound texture unbinds it.
+        }
+        glDeleteTextures(1, &_id);
+        _id = 0;
+        --_gl.stats.textures;
+        if (_load) {
+            _gl.resident_bytes -= bytes();
+        }
+    }
+
+  private:
+    static bool partly_covered(const PixMap& overlay) {
+        for (int y = 0; y < overlay.size().height; ++y) {
+            for (int x = 0; x < overlay.size().width; ++x) {
+                const uint8_t alpha = overlay.get(x, y).alpha;
+                if ((alpha != 0) && (alpha != 255)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    Rect panel(int i) const {
+        return Rect(_size.width * i, 0, _size.width * (i + 1), _size.height);
+    }
+
+    int64_t bytes() const { return int64_t{4} * _panels * _size.width * _size.height; }
+
+    void upload(const PixMap& image) {
+        glGenTextures(1, &_id);
+        _gl.bind_texture(_id);
         glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -215,23 +360,45 @@ class OpenGlTextureImpl : public Texture::Impl {
 #else
 #error "Couldn't determine endianness of platform"
 #endif
-
-        // Add a 1-pixel clear border.  Color mode 5 (outline) won't work unless we do this.
-        Size size = image.size();
-        size.width += 2;
-        size.height += 2;
-        ArrayPixMap copy(size);
-        copy.fill(RgbColor::clear());
-        copy.view(Rect(1, 1, size.width - 1, size.height - 1)).copy(image);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, image.row_bytes());
         glTexImage2D(
-                GL_TEXTURE_RECTANGLE, 0, GL_RGBA8, size.width, size.height, 0, GL_BGRA, type,
-                copy.bytes());
+                GL_TEXTURE_RECTANGLE, 0, GL_RGBA8, image.size().width, image.size().height, 0,
+                GL_BGRA, type, image.bytes());
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        ++_gl.stats.textures;
     }
 
+    const Size                     _size;
+    const VideoDriver::AtlasLoader _load;  // null unless this is an atlas page
+    const int                      _overlay_offset;
+    OpenGlVideoDriver::Context&    _gl;
+    const int64_t                  _serial     = ++_gl.pages_created;
+    GLuint                         _id         = 0;
+    int                            _panels     = 1;  // images of `_size` across the texture
+    int64_t                        _last_drawn = 0;
+};
+
+// Draws `region` of `page`, which must have at least a 1-pixel clear border within the page.
+// Color mode 5 (outline) won't work without it. If `tint` is not -1, the page's overlay is blended
+// over the region in shades of hue `tint`.
+class OpenGlTextureImpl : public Texture::Impl {
+  public:
+    OpenGlTextureImpl(
+            pn::string_view name, std::shared_ptr<OpenGlTexturePage> page, Rect region, int scale,
+            int tint, OpenGlVideoDriver::Context& gl)
+            : _name(name.copy()),
+              _page(std::move(page)),
+              _region(region),
+              _size(region.size()),
+              _scale(scale),
+              _tint(tint),
+              _gl(gl) {}
+
     virtual pn::string_view name() const { return _name; }
 
     virtual void draw(const Rect& draw_rect) const {
-        _uniforms.color_mode.set(DRAW_SPRITE_MODE);
+        _gl.flush();
+        _gl.use(DRAW_SPRITE_MODE);
         draw_internal(draw_rect, RgbColor::white());
     }
 
@@ -242,140 +409,137 @@ class OpenGlTextureImpl : public Texture::Impl {
     }
 
     virtual void draw_shaded(const Rect& draw_rect, const RgbColor& tint) const {
-        _uniforms.color_mode.set(TINT_SPRITE_MODE);
+        _gl.flush();
+        _gl.use(TINT_SPRITE_MODE);
         draw_internal(draw_rect, tint);
     }
 
     virtual void draw_static(const Rect& draw_rect, const RgbColor& color, uint8_t frac) const {
-        _uniforms.color_mode.set(STATIC_SPRITE_MODE);
-        _uniforms.static_fraction.set(frac / 255.0f);
+        _gl.flush();
+        _gl.use(STATIC_SPRITE_MODE).static_fraction.set(frac / 255.0f);
         draw_internal(draw_rect, color);
     }
 
     virtual void draw_outlined(
             const Rect& draw_rect, const RgbColor& outline_color,
             const RgbColor& fill_color) const {
-        _uniforms.color_mode.set(OUTLINE_SPRITE_MODE);
-        _uniforms.unit.set({float(_size.width) / draw_rect.width(),
-                            float(_size.height) / draw_rect.height()});
-        _uniforms.outline_color.set({outline_color.red / 255.0f, outline_color.green / 255.0f,
-                                     outline_color.blue / 255.0f, outline_color.alpha / 255.0f});
+        _gl.flush();
+        const OpenGlVideoDriver::Uniforms& uniforms = _gl.use(OUTLINE_SPRITE_MODE);
+        uniforms.unit.set({float(_size.width) / draw_rect.width(),
+                           float(_size.height) / draw_rect.height()});
+        const RgbColor outline = apple_rgb_to_srgb(outline_color);
+        uniforms.outline_color.set(
+                {outline.red / 255.0f, outline.green / 255.0f, outline.blue / 255.0f,
+                 outline.alpha / 255.0f});
+        // Neighbors are sampled no further out than the centers of the border pixels, as if the
+        // region were its own texture clamped to its edges.
+        uniforms.outline_bounds.set(
+                {_region.left - 0.5f, _region.top - 0.5f, _region.right + 0.5f,
+                 _region.bottom + 0.5f});
         draw_internal(draw_rect, fill_color);
     }
 
     virtual const Size& size() const { return _size; }
 
-  private:
-    virtual void draw_internal(const Rect& draw_rect, const RgbColor& tint) const {
-        glEnableVertexAttribArray(0);
-        glEnableVertexAttribArray(1);
-        glEnableVertexAttribArray(2);
-
-        glBindBuffer(GL_ARRAY_BUFFER, _vbuf[0]);
-        GLshort vertices[] = {
-                GLshort(draw_rect.left),   GLshort(draw_rect.top),   GLshort(draw_rect.left),
-                GLshort(draw_rect.bottom), GLshort(draw_rect.right), GLshort(draw_rect.bottom),
-                GLshort(draw_rect.right),  GLshort(draw_rect.top),
+    OpenGlTexturePage& page() const { return *_page; }
+    int                tint() const { return _tint; }
+
+    // Sets the uniforms that tint() depends on.
+    void set_tint() const { _gl.set_tint(_tint, _page->overlay_offset()); }
+
+    // Appends the two triangles that draw this texture into `dest`.
+    void append_triangles(
+            const Rect& dest, const RgbColor& tint,
+            std::vector<OpenGlVideoDriver::Context::SpriteVertex>* vertices) const {
+        const Rect     source = texture_rect();
+        const RgbColor c      = apple_rgb_to_srgb(tint);
+        auto           vertex = [&c](int32_t x, int32_t y, int32_t u, int32_t v) {
+            return OpenGlVideoDriver::Context::SpriteVertex{
+                    GLshort(x), GLshort(y), {c.red, c.green, c.blue, c.alpha}, GLshort(u),
+                    GLshort(v)};
         };
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STREAM_DRAW);
-        glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, 0, nullptr);
-
-        glBindBuffer(GL_ARRAY_BUFFER, _vbuf[1]);
-        GLubyte colors[] = {
-                tint.red,  tint.green, tint.blue, tint.alpha, tint.red,  tint.green,
-                tint.blue, tint.alpha, tint.red,  tint.green, tint.blue, tint.alpha,
-                tint.red,  tint.green, tint.blue, tint.alpha,
-        };
-        glBufferData(GL_ARRAY_BUFFER, sizeof(colors), colors, GL_STREAM_DRAW);
-        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
-
-        glBindBuffer(GL_ARRAY_BUFFER, _vbuf[2]);
-        const int32_t w            = _size.width / _scale;
-        const int32_t h            = _size.height / _scale;
-        GLshort       tex_coords[] = {
-                GLshort(1),     GLshort(1),     GLshort(1),     GLshort(h + 1),
-                GLshort(w + 1), GLshort(h + 1), GLshort(w + 1), GLshort(1),
-        };
-        glBufferData(GL_ARRAY_BUFFER, sizeof(tex_coords), tex_coords, GL_STREAM_DRAW);
-        glVertexAttribPointer(2, 2, GL_SHORT, GL_FALSE, 0, nullptr);
+        vertices->push_back(vertex(dest.left, dest.top, source.left, source.top));
+        vertices->push_back(vertex(dest.left, dest.bottom, source.left, source.bottom));
+        vertices->push_back(vertex(dest.right, dest.bottom, source.right, source.bottom));
+        vertices->push_back(vertex(dest.left, dest.top, source.left, source.top));
+        vertices->push_back(vertex(dest.right, dest.bottom, source.right, source.bottom));
+        vertices->push_back(vertex(dest.right, dest.top, source.right, source.top));
+    }
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_RECTANGLE, _texture.id);
-        glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+  private:
+    Rect texture_rect() const {
+        const int32_t w = _size.width / _scale;
+        const int32_t h = _size.height / _scale;
+        return Rect(_region.left, _region.top, _region.left + w, _region.top + h);
+    }
 
-        glDisableVertexAttribArray(2);
-        glDisableVertexAttribArray(1);
-        glDisableVertexAttribArray(0);
+    virtual void draw_internal(const Rect& draw_rect, const RgbColor& tint) const {
+        draw_sprite(draw_rect, texture_rect(), tint);
     }
 
     virtual void begin_quads() const {
-        _uniforms.color_mode.set(TINT_SPRITE_MODE);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_RECTANGLE, _texture.id);
+        _gl.flush();
+        _gl.use(TINT_SPRITE_MODE);
     }
 
     virtual void end_quads() const {}
 
     virtual void draw_quad(const Rect& dest, const Rect& source, const RgbColor& tint) const {
-        glEnableVertexAttribArray(0);
-        glEnableVertexAttribArray(1);
-        glEnableVertexAttribArray(2);
+        if (!_gl.batch.empty()) {
+            begin_quads();  // draw queued primitives first, then restore sprite state.
+        }
+        Rect texture_rect = source;
+        texture_rect.scale(_scale, _scale);
+        texture_rect.offset(_region.left, _region.top);
+        draw_sprite(dest, texture_rect, tint);
+    }
 
-        glBindBuffer(GL_ARRAY_BUFFER, _vbuf[0]);
-        GLshort vertices[] = {
-                GLshort(dest.left),   GLshort(dest.top),   GLshort(dest.left),
-                GLshort(dest.bottom), GLshort(dest.right), GLshort(dest.bottom),
-                GLshort(dest.right),  GLshort(dest.top),
+    void draw_sprite(const Rect& dest, const Rect& texture_rect, const RgbColor& tint) const {
+        typedef OpenGlVideoDriver::Context::SpriteVertex Vertex;
+        const RgbColor c      = apple_rgb_to_srgb(tint);
+        auto           vertex = [&c](int32_t x, int32_t y, int32_t u, int32_t v) {
+            return Vertex{GLshort(x), GLshort(y), {c.red, c.green, c.blue, c.alpha},
+                          GLshort(u), GLshort(v)};
         };
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STREAM_DRAW);
-        glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, 0, nullptr);
-
-        glBindBuffer(GL_ARRAY_BUFFER, _vbuf[1]);
-        GLubyte colors[] = {
-                tint.red,  tint.green, tint.blue, tint.alpha, tint.red,  tint.green,
-                tint.blue, tint.alpha, tint.red,  tint.green, tint.blue, tint.alpha,
-                tint.red,  tint.green, tint.blue, tint.alpha,
+        const Vertex vertices[] = {
+                vertex(dest.left, dest.top, texture_rect.left, texture_rect.top),
+                vertex(dest.left, dest.bottom, texture_rect.left, texture_rect.bottom),
+                vertex(dest.right, dest.bottom, texture_rect.right, texture_rect.bottom),
+                vertex(dest.right, dest.top, texture_rect.right, texture_rect.top),
         };
-        glBufferData(GL_ARRAY_BUFFER, sizeof(colors), colors, GL_STREAM_DRAW);
-        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
+        if (!_page->bind()) {
+            return;
+        }
+        const int32_t first = _gl.upload(vertices, 4);
+        _gl.bind(_gl.sprite_array);
+        set_tint();
+        glDrawArrays(GL_TRIANGLE_FAN, first, 4);
+        ++_gl.stats.draw_calls;
+    }
 
-        Rect texture_rect = source;
-        texture_rect.scale(_scale, _scale);
-        texture_rect.offset(1, 1);
-        glBindBuffer(GL_ARRAY_BUFFER, _vbuf[2]);
-        GLshort tex_coords[] = {
-                GLshort(texture_rect.left),  GLshort(texture_rect.top),
-                GLshort(texture_rect.left),  GLshort(texture_rect.bottom),
-                GLshort(texture_rect.right), GLshort(texture_rect.bottom),
-                GLshort(texture_rect.right), GLshort(texture_rect.top),
-        };
-        glBufferData(GL_ARRAY_BUFFER, sizeof(tex_coords), tex_coords, GL_STREAM_DRAW);
-        glVertexAttribPointer(2, 2, GL_SHORT, GL_FALSE, 0, nullptr);
+    const pn::string                         _name;
+    const std::shared_ptr<OpenGlTexturePage> _page;
+    const Rect                               _region;
+    Size                                     _size;
+    int                                      _scale;
+    int                                      _tint;
+    OpenGlVideoDriver::Context&              _gl;
+};
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_RECTANGLE, _texture.id);
-        glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+class OpenGlTextureAtlas : public TextureAtlas::Impl {
+  public:
+    OpenGlTextureAtlas(Size size, VideoDriver::AtlasLoader load, OpenGlVideoDriver::Context& gl)
+            : _page(std::make_shared<OpenGlTexturePage>(size, std::move(load), gl)), _gl(gl) {}
 
-        glDisableVertexAttribArray(2);
-        glDisableVertexAttribArray(1);
-        glDisableVertexAttribArray(0);
+    virtual Texture texture(pn::string_view name, const Rect& region, Hue hue) const {
+        const bool tinted = (hue != Hue::GRAY);
+        return unique_ptr<Texture::Impl>(new OpenGlTextureImpl(
+                name, _page, region, 1, tinted ? static_cast<int>(hue) : -1, _gl));
     }
 
-    struct Texture {
-        Texture() { glGenTextures(1, &id); }
-        Texture(const Texture&) = delete;
-        Texture& operator=(const Texture&) = delete;
-        ~Texture() { glDeleteTextures(1, &id); }
-
-        GLuint id;
-    };
-
-    const pn::string                   _name;
-    Texture                            _texture;
-    Size                               _size;
-    int                                _scale;
-    const OpenGlVideoDriver::Uniforms& _uniforms;
-    GLuint*                            _vbuf;
+  private:
+    const std::shared_ptr<OpenGlTexturePage> _page;
+    OpenGlVideoDriver::Context&              _gl;
 };
 
 }  // namespace
@@ -385,73 +549,301 @@ OpenGlVideoDriver::OpenGlVideoDriver() : _static_seed{0} {}
 int OpenGlVideoDriver::scale() const { return viewport_size().width / screen_size().width; }
 
 Texture OpenGlVideoDriver::texture(pn::string_view name, const PixMap& content, int scale) {
-    return unique_ptr<Texture::Impl>(
-            new OpenGlTextureImpl(name, content, scale, _uniforms, _vbuf));
+    Size size = content.size();
+    size.width += 2;
+    size.height += 2;
+    ArrayPixMap copy(size);
+    copy.fill(RgbColor::clear());
+    copy.view(Rect(1, 1, size.width - 1, size.height - 1)).copy(content);
+    std::shared_ptr<OpenGlTexturePage> page =
+            std::make_shared<OpenGlTexturePage>(std::move(copy), _gl);
+    return unique_ptr<Texture::Impl>(new OpenGlTextureImpl(
+            name, std::move(page), Rect(1, 1, size.width - 1, size.height - 1), scale, -1, _gl));
 }
 
-void OpenGlVideoDriver::begin_rects() { _uniforms.color_mode.set(FILL_MODE); }
-
-void OpenGlVideoDriver::batch_rect(const Rect& rect, const RgbColor& color) {
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
+TextureAtlas OpenGlVideoDriver::atlas(Size size, AtlasLoader load) {
+    return unique_ptr<TextureAtlas::Impl>(new OpenGlTextureAtlas(size, std::move(load), _gl));
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, _vbuf[0]);
-    GLshort vertices[] = {
-            GLshort(rect.right), GLshort(rect.top),    GLshort(rect.left),  GLshort(rect.top),
-            GLshort(rect.left),  GLshort(rect.bottom), GLshort(rect.right), GLshort(rect.bottom),
+void OpenGlVideoDriver::draw_sprites(const std::vector<SpriteInstance>& sprites) {
+    // Sprites are gathered into runs that share a mode, atlas page and tint, and each run is drawn
+    // with one upload and one draw call. A sprite joins the last run with its key, and so may be
+    // drawn ahead of sprites issued before it, only if it overlaps none of them; overlapping
+    // sprites are always drawn in the order they were issued. Static sprites are only grouped with
+    // others of the same fraction, since it is a uniform; they are rare enough that this costs
+    // little.
+    auto key = [](const SpriteInstance& s) {
+        const OpenGlTextureImpl& texture = texture_impl<OpenGlTextureImpl>(*s.texture);
+        return std::make_tuple(
+                s.is_static, s.is_static ? s.frac : 0, texture.page().serial(), texture.tint());
     };
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STREAM_DRAW);
-    glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, 0, nullptr);
-
-    glBindBuffer(GL_ARRAY_BUFFER, _vbuf[1]);
-    GLubyte colors[] = {
-            color.red,  color.green, color.blue, color.alpha, color.red,  color.green,
-            color.blue, color.alpha, color.red,  color.green, color.blue, color.alpha,
-            color.red,  color.green, color.blue, color.alpha,
+    typedef decltype(key(sprites.front())) Key;
+    struct Run {
+        Key                                key;
+        Rect                               bounds;  // of all of `sprites`
+        std::vector<const SpriteInstance*> sprites;
+
+        bool overlaps(const Rect& rect) const {
+            if (!bounds.intersects(rect)) {
+                return false;
+            }
+            return std::any_of(sprites.begin(), sprites.end(), [&rect](const SpriteInstance* s) {
+                return s->rect.intersects(rect);
+            });
+        }
     };
-    glBufferData(GL_ARRAY_BUFFER, sizeof(colors), colors, GL_STREAM_DRAW);
-    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
 
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    std::vector<Run> runs;
+    for (const SpriteInstance& sprite : sprites) {
+        const Key k    = key(sprite);
+        Run*      join = nullptr;
+        for (auto run = runs.rbegin(); run != runs.rend(); ++run) {
+            if (run->key == k) {
+                join = &*run;
+                break;
+            } else if (run->overlaps(sprite.rect)) {
+                break;
+            }
+        }
+        if (join) {
+            join->bounds.enlarge_to(sprite.rect);
+        } else {
+            runs.push_back(Run{k, sprite.rect, {}});
+            join = &runs.back();
+        }
+        join->sprites.push_back(&sprite);
+    }
+
+    _gl.flush();
+    for (const Run& run : runs) {
+        const SpriteInstance&    first         = *run.sprites.front();
+        const OpenGlTextureImpl& first_texture = texture_impl<OpenGlTextureImpl>(*first.texture);
+        if (!first_texture.page().bind()) {
+            continue;  // try again next frame.
+        }
+        if (first.is_static) {
+            _gl.use(STATIC_SPRITE_MODE).static_fraction.set(first.frac / 255.0f);
+        } else {
+            _gl.use(DRAW_SPRITE_MODE);
+        }
+        first_texture.set_tint();
+
+        _gl.sprites.clear();
+        for (const SpriteInstance* sprite : run.sprites) {
+            const OpenGlTextureImpl& texture = texture_impl<OpenGlTextureImpl>(*sprite->texture);
+            texture.append_triangles(
+                    sprite->rect, sprite->is_static ? sprite->color : RgbColor::white(),
+                    &_gl.sprites);
+        }
+        _gl.draw(GL_TRIANGLES, _gl.sprite_array, _gl.sprites.data(), _gl.sprites.size());
+    }
+}
 
-    glDisableVertexAttribArray(1);
-    glDisableVertexAttribArray(0);
+void OpenGlVideoDriver::set_texture_limits(int64_t budget, int uploads_per_frame) {
+    _gl.texture_budget = budget;
+    _gl.max_uploads    = uploads_per_frame;
 }
 
-void OpenGlVideoDriver::end_rects() {}
+void OpenGlVideoDriver::Context::evict() {
+    while (resident_bytes > texture_budget) {
+        OpenGlTexturePage* lru = nullptr;
+        for (OpenGlTexturePage* page : atlas_pages) {
+            if (!page->evictable()) {
+                continue;
+            } else if (
+                    !lru || (std::make_pair(page->last_drawn(), page->serial()) <
+                             std::make_pair(lru->last_drawn(), lru->serial()))) {
+                lru = page;
+            }
+        }
+        if (!lru) {
+            return;
+        }
+        lru->unload();
+        ++stats.page_evictions;
+    }
+}
 
-void OpenGlVideoDriver::dither_rect(const Rect& rect, const RgbColor& color) {
-    _uniforms.color_mode.set(DITHER_MODE);
-    batch_rect(rect, color);
+OpenGlVideoDriver::Uniforms& OpenGlVideoDriver::Context::use(int mode) {
+    Uniforms& uniforms = programs[mode].uniforms;
+    if (mode != current_mode) {
+        glUseProgram(programs[mode].id);
+        current_mode = mode;
+        ++stats.program_uses;
+    }
+    uniforms.screen.set(screen);
+    uniforms.scale.set(scale);
+    uniforms.seed.set(seed);
+    return uniforms;
 }
 
-void OpenGlVideoDriver::begin_points() { _uniforms.color_mode.set(FILL_MODE); }
+void OpenGlVideoDriver::Context::set_tint(int hue, int overlay_offset) {
+    const Uniforms& uniforms = programs[current_mode].uniforms;
+    uniforms.tint.set(hue);
+    if (hue >= 0) {
+        uniforms.overlay_offset.set(overlay_offset);
+    }
+}
 
-void OpenGlVideoDriver::end_points() {}
+void OpenGlVideoDriver::Context::bind_texture(uint32_t texture) {
+    if (texture != bound_texture) {
+        glBindTexture(GL_TEXTURE_RECTANGLE, texture);
+        bound_texture = texture;
+        ++stats.texture_binds;
+    }
+}
 
-void OpenGlVideoDriver::batch_point(const Point& at, const RgbColor& color) {
+void OpenGlVideoDriver::Context::next_segment() {
+    if (fenced) {
+        fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        segment         = (segment + 1) % kSegments;
+        if (GLsync fence = static_cast<GLsync>(fences[segment])) {
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) ==
+                   GL_TIMEOUT_EXPIRED) {
+            }
+            glDeleteSync(fence);
+            fences[segment] = nullptr;
+        }
+    } else {
+        segment = (segment + 1) % kSegments;
+        if (segment == 0) {
+            glBufferData(
+                    GL_ARRAY_BUFFER, kSegments * kSegmentVertices * sizeof(ColorVertex), nullptr,
+                    GL_STREAM_DRAW);
+        }
+    }
+    head = segment * kSegmentVertices;
+}
+
+int32_t OpenGlVideoDriver::Context::upload(const void* vertices, int count) {
+    if ((head + count) > ((segment + 1) * kSegmentVertices)) {
+        next_segment();
+    }
+    const GLintptr   offset = head * sizeof(ColorVertex);
+    const GLsizeiptr size   = count * sizeof(ColorVertex);
+    if (fenced) {
+        void* dest = glMapBufferRange(
+                GL_ARRAY_BUFFER, offset, size,
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        memcpy(dest, vertices, size);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, vertices);
+    }
+    ++stats.buffer_uploads;
+
+    const int32_t first = head;
+    head += count;
+    return first;
+}
+
+// Enables and points the attributes of one of the two vertex formats at `stream`.
+static void point_attributes(bool sprites) {
+    typedef OpenGlVideoDriver::Context::ColorVertex  ColorVertex;
+    typedef OpenGlVideoDriver::Context::SpriteVertex SpriteVertex;
     glEnableVertexAttribArray(0);
     glEnableVertexAttribArray(1);
+    if (sprites) {
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(
+                0, 2, GL_SHORT, GL_FALSE, sizeof(SpriteVertex),
+                reinterpret_cast<void*>(offsetof(SpriteVertex, x)));
+        glVertexAttribPointer(
+                1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteVertex),
+                reinterpret_cast<void*>(offsetof(SpriteVertex, color)));
+        glVertexAttribPointer(
+                2, 2, GL_SHORT, GL_FALSE, sizeof(SpriteVertex),
+                reinterpret_cast<void*>(offsetof(SpriteVertex, u)));
+    } else {
+        glDisableVertexAttribArray(2);
+        glVertexAttribPointer(
+                0, 2, GL_FLOAT, GL_FALSE, sizeof(ColorVertex),
+                reinterpret_cast<void*>(offsetof(ColorVertex, x)));
+        glVertexAttribPointer(
+                1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ColorVertex),
+                reinterpret_cast<void*>(offsetof(ColorVertex, color)));
+    }
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, _vbuf[0]);
-    GLfloat vertices[] = {GLfloat(at.h + 0.5), GLfloat(at.v + 0.5)};
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STREAM_DRAW);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-
-    glBindBuffer(GL_ARRAY_BUFFER, _vbuf[1]);
-    GLubyte colors[] = {
-            color.red,
-            color.green,
-            color.blue,
-            color.alpha,
-    };
-    glBufferData(GL_ARRAY_BUFFER, sizeof(colors), colors, GL_STREAM_DRAW);
-    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
+void OpenGlVideoDriver::Context::bind(uint32_t array) {
+    if (array == bound_array) {
+        return;
+    }
+    if (vertex_arrays) {
+        glBindVertexArray(array);
+    } else {
+        point_attributes(array == sprite_array);
+    }
+    bound_array = array;
+}
+
+void OpenGlVideoDriver::Context::queue(int mode, int color_mode) {
+    if ((mode != batch_mode) || (color_mode != batch_color_mode)) {
+        flush();
+        batch_mode       = mode;
+        batch_color_mode = color_mode;
+    }
+}
+
+void OpenGlVideoDriver::Context::push(float x, float y, const RgbColor& color) {
+    const RgbColor c = apple_rgb_to_srgb(color);
+    batch.push_back(ColorVertex{x, y, {c.red, c.green, c.blue, c.alpha}});
+}
+
+void OpenGlVideoDriver::Context::flush() {
+    if (batch.empty()) {
+        return;
+    }
+    use(batch_color_mode);
+    draw(batch_mode, color_array, batch.data(), batch.size());
+    batch.clear();
+}
+
+void OpenGlVideoDriver::Context::draw(
+        int mode, uint32_t array, const void* vertices, size_t count) {
+    bind(array);
+
+    // Runs larger than a segment are split, at a multiple of every primitive's size.
+    const int      kMaxChunk = kSegmentVertices - (kSegmentVertices % 6);
+    const uint8_t* data      = static_cast<const uint8_t*>(vertices);
+    for (size_t i = 0; i < count; i += kMaxChunk) {
+        const int     n     = std::min<size_t>(count - i, kMaxChunk);
+        const int32_t first = upload(data + (i * sizeof(ColorVertex)), n);
+        glDrawArrays(mode, first, n);
+        ++stats.draw_calls;
+    }
+}
+
+void OpenGlVideoDriver::begin_rects() { _gl.queue(GL_TRIANGLES, FILL_MODE); }
 
-    glDrawArrays(GL_POINTS, 0, 1);
+void OpenGlVideoDriver::batch_rect(const Rect& rect, const RgbColor& color) {
+    fill_rect(rect, color, FILL_MODE);
+}
+
+void OpenGlVideoDriver::end_rects() { _gl.flush(); }
+
+void OpenGlVideoDriver::dither_rect(const Rect& rect, const RgbColor& color) {
+    fill_rect(rect, color, DITHER_MODE);
+}
 
-    glDisableVertexAttribArray(1);
-    glDisableVertexAttribArray(0);
+// Rects are drawn as pairs of triangles, rather than fans, so that a batch can hold many.
+void OpenGlVideoDriver::fill_rect(const Rect& rect, const RgbColor& color, int color_mode) {
+    _gl.queue(GL_TRIANGLES, color_mode);
+    _gl.push(rect.right, rect.top, color);
+    _gl.push(rect.left, rect.top, color);
+    _gl.push(rect.left, rect.bottom, color);
+    _gl.push(rect.right, rect.top, color);
+    _gl.push(rect.left, rect.bottom, color);
+    _gl.push(rect.right, rect.bottom, color);
+}
+
+void OpenGlVideoDriver::begin_points() { _gl.queue(GL_POINTS, FILL_MODE); }
+
+void OpenGlVideoDriver::end_points() { _gl.flush(); }
+
+void OpenGlVideoDriver::batch_point(const Point& at, const RgbColor& color) {
+    _gl.queue(GL_POINTS, FILL_MODE);
+    _gl.push(at.h + 0.5f, at.v + 0.5f, color);
 }
 
 void OpenGlVideoDriver::draw_point(const Point& at, const RgbColor& color) {
@@ -460,9 +852,9 @@ void OpenGlVideoDriver::draw_point(const Point& at, const RgbColor& color) {
     end_points();
 }
 
-void OpenGlVideoDriver::begin_lines() { _uniforms.color_mode.set(FILL_MODE); }
+void OpenGlVideoDriver::begin_lines() { _gl.queue(GL_LINES, FILL_MODE); }
 
-void OpenGlVideoDriver::end_lines() {}
+void OpenGlVideoDriver::end_lines() { _gl.flush(); }
 
 void OpenGlVideoDriver::batch_line(const Point& from, const Point& to, const RgbColor& color) {
     //
@@ -497,26 +889,9 @@ void OpenGlVideoDriver::batch_line(const Point& from, const Point& to, const Rgb
         y2 += 1.0f;
     }
 
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-
-    glBindBuffer(GL_ARRAY_BUFFER, _vbuf[0]);
-    GLfloat vertices[] = {x1, y1, x2, y2};
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STREAM_DRAW);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-
-    glBindBuffer(GL_ARRAY_BUFFER, _vbuf[1]);
-    GLubyte colors[] = {
-            color.red, color.green, color.blue, color.alpha,
-            color.red, color.green, color.blue, color.alpha,
-    };
-    glBufferData(GL_ARRAY_BUFFER, sizeof(colors), colors, GL_STREAM_DRAW);
-    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
-
-    glDrawArrays(GL_LINES, 0, 2);
-
-    glDisableVertexAttribArray(1);
-    glDisableVertexAttribArray(0);
+    _gl.queue(GL_LINES, FILL_MODE);
+    _gl.push(x1, y1, color);
+    _gl.push(x2, y2, color);
 }
 
 void OpenGlVideoDriver::draw_line(const Point& from, const Point& to, const RgbColor& color) {
@@ -525,52 +900,117 @@ void OpenGlVideoDriver::draw_line(const Point& from, const Point& to, const RgbC
     // end_lines();
 }
 
-void OpenGlVideoDriver::draw_triangle(const Rect& rect, const RgbColor& color) {
-    size_t size = min(rect.width(), rect.height());
-    Rect   to(0, 0, size, size);
+// The square that draw_triangle(), draw_diamond() and draw_plus() draw into.
+static Rect icon_rect(const Rect& rect) {
+    int32_t size = min(rect.width(), rect.height());
+    Rect    to(0, 0, size, size);
     to.offset(rect.left, rect.top);
-    if (_triangles.find(size) == _triangles.end()) {
-        ArrayPixMap pix(size, size);
-        pix.fill(RgbColor::clear());
-        draw_triangle_up(&pix, RgbColor::white());
-        _triangles[size] = texture("", pix, 1);
-    }
-    _triangles[size].draw_shaded(to, color);
+    return to;
+}
+
+void OpenGlVideoDriver::draw_triangle(const Rect& rect, const RgbColor& color) {
+    const Rect to = icon_rect(rect);
+    icon(IconInstance::TRIANGLE, to.width()).draw_shaded(to, color);
 }
 
 void OpenGlVideoDriver::draw_diamond(const Rect& rect, const RgbColor& color) {
-    size_t size = min(rect.width(), rect.height());
-    Rect   to(0, 0, size, size);
-    to.offset(rect.left, rect.top);
-    if (_diamonds.find(size) == _diamonds.end()) {
-        ArrayPixMap pix(size, size);
-        pix.fill(RgbColor::clear());
-        draw_compat_diamond(&pix, RgbColor::white());
-        _diamonds[size] = texture("", pix, 1);
-    }
-    _diamonds[size].draw_shaded(to, color);
+    const Rect to = icon_rect(rect);
+    icon(IconInstance::DIAMOND, to.width()).draw_shaded(to, color);
 }
 
 void OpenGlVideoDriver::draw_plus(const Rect& rect, const RgbColor& color) {
-    size_t size = min(rect.width(), rect.height());
-    Rect   to(0, 0, size, size);
-    to.offset(rect.left, rect.top);
-    if (_pluses.find(size) == _pluses.end()) {
-        ArrayPixMap pix(size, size);
-        pix.fill(RgbColor::clear());
-        draw_compat_plus(&pix, RgbColor::white());
-        _pluses[size] = texture("", pix, 1);
+    const Rect to = icon_rect(rect);
+    icon(IconInstance::PLUS, to.width()).draw_shaded(to, color);
+}
+
+void OpenGlVideoDriver::draw_icons(const std::vector<IconInstance>& icons) {
+    if (icons.empty()) {
+        return;
+    }
+    // Look up every icon first, since adding one rebuilds the page.
+    for (const IconInstance& i : icons) {
+        if (i.shape != IconInstance::SQUARE) {
+            icon(i.shape, icon_rect(i.rect).width());
+        }
+    }
+    const Texture& square = icon(IconInstance::SQUARE, 1);
+
+    // Since every icon is on one page, they are all drawn in order with one draw call.
+    _gl.flush();
+    _gl.use(TINT_SPRITE_MODE);
+    _gl.sprites.clear();
+    for (const IconInstance& i : icons) {
+        if (i.shape == IconInstance::SQUARE) {
+            texture_impl<OpenGlTextureImpl>(square).append_triangles(
+                    i.rect, i.color, &_gl.sprites);
+        } else {
+            const Rect to = icon_rect(i.rect);
+            texture_impl<OpenGlTextureImpl>(icon(i.shape, to.width()))
+                    .append_triangles(to, i.color, &_gl.sprites);
+        }
+    }
+    texture_impl<OpenGlTextureImpl>(square).page().bind();
+    _gl.set_tint(-1, 0);
+    _gl.draw(GL_TRIANGLES, _gl.sprite_array, _gl.sprites.data(), _gl.sprites.size());
+}
+
+const Texture& OpenGlVideoDriver::icon(IconInstance::Shape shape, int size) {
+    const std::pair<IconInstance::Shape, int> key = {shape, size};
+    auto                                      it  = _icons.find(key);
+    if (it != _icons.end()) {
+        return it->second;
+    }
+
+    // Lay out every icon in one row, each with a 1-pixel clear border.
+    std::vector<std::pair<IconInstance::Shape, int>> keys;
+    Size                                             page_size = {0, 0};
+    for (const auto& kv : _icons) {
+        keys.push_back(kv.first);
+    }
+    keys.push_back(key);
+    for (const auto& k : keys) {
+        page_size.width += k.second + 2;
+        page_size.height = std::max(page_size.height, k.second + 2);
+    }
+
+    ArrayPixMap       page(page_size);
+    std::vector<Rect> regions;
+    page.fill(RgbColor::clear());
+    int32_t x = 0;
+    for (const auto& k : keys) {
+        const Rect   region(x + 1, 1, x + 1 + k.second, 1 + k.second);
+        PixMap::View pix = page.view(region);
+        switch (k.first) {
+            case IconInstance::SQUARE: pix.fill(RgbColor::white()); break;
+            case IconInstance::TRIANGLE: draw_triangle_up(&pix, RgbColor::white()); break;
+            case IconInstance::DIAMOND: draw_compat_diamond(&pix, RgbColor::white()); break;
+            case IconInstance::PLUS: draw_compat_plus(&pix, RgbColor::white()); break;
+        }
+        regions.push_back(region);
+        x += k.second + 2;
     }
-    _pluses[size].draw_shaded(to, color);
+
+    // Not an atlas page, since `page` doesn't outlive this call.
+    std::shared_ptr<OpenGlTexturePage> shared =
+            std::make_shared<OpenGlTexturePage>(std::move(page), _gl);
+    _icons.clear();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        _icons[keys[i]] = unique_ptr<Texture::Impl>(
+                new OpenGlTextureImpl("", shared, regions[i], 1, -1, _gl));
+    }
+    return _icons[key];
 }
 
 void* OpenGlVideoDriver::get_proc_address(const char* proc_name) const {
   return nullptr;
 }
 
-static GLuint make_shader(GLenum shader_type, const GLchar* source, pn::string_view version) {
+// Compiles `source` for GLSL `version`, with `defines` inserted after the #version line.
+static GLuint make_shader(
+        GLenum shader_type, const GLchar* source, pn::string_view version,
+        pn::string_view defines = "") {
     GLuint        shader      = glCreateShader(shader_type);
-    pn::string    version_def = pn::format("#version {}\n", version);
+    pn::string    version_def = pn::format("#version {}\n{}", version, defines);
     const GLchar* sources[2]  = {version_def.c_str(), source};
     glShaderSource(shader, 2, sources, NULL);
     glCompileShader(shader);
@@ -596,40 +1036,83 @@ OpenGlVideoDriver::MainLoop::Setup::Setup(OpenGlVideoDriver& driver) {
     glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 
-    GLuint fragment = make_shader(GL_FRAGMENT_SHADER, glsl::fragment, driver.glsl_version());
-    GLuint vertex   = make_shader(GL_VERTEX_SHADER, glsl::vertex, driver.glsl_version());
-
-    GLuint program = glCreateProgram();
-    glAttachShader(program, fragment);
-    glAttachShader(program, vertex);
-    glBindAttribLocation(program, 0, "vertex");
-    glBindAttribLocation(program, 1, "in_color");
-    glBindAttribLocation(program, 2, "tex_coord");
-    glLinkProgram(program);
-    glValidateProgram(program);
-    GLint linked;
-    glGetProgramiv(program, GL_LINK_STATUS, &linked);
-    if (linked == GL_FALSE) {
-        gl_log(program);
-        throw std::runtime_error("linking failed");
-    }
-
-    GLuint array;
-    glGenVertexArrays(1, &array);
-    glBindVertexArray(array);
-
-    glGenBuffers(3, driver._vbuf);
-
-    driver._uniforms.screen.load(program);
-    driver._uniforms.scale.load(program);
-    driver._uniforms.color_mode.load(program);
-    driver._uniforms.sprite.load(program);
-    driver._uniforms.static_image.load(program);
-    driver._uniforms.static_fraction.load(program);
-    driver._uniforms.unit.load(program);
-    driver._uniforms.outline_color.load(program);
-    driver._uniforms.seed.load(program);
-    glUseProgram(program);
+    // Every program is linked up front, so that switching modes never compiles anything.
+    Context& gl     = driver._gl;
+    GLuint   vertex = make_shader(GL_VERTEX_SHADER, glsl::vertex, driver.glsl_version());
+    for (int mode = 0; mode < Context::kColorModes; ++mode) {
+        GLuint fragment = make_shader(
+                GL_FRAGMENT_SHADER, glsl::fragment, driver.glsl_version(),
+                pn::format("#define COLOR_MODE {}\n", mode));
+
+        GLuint program = glCreateProgram();
+        glAttachShader(program, fragment);
+        glAttachShader(program, vertex);
+        glBindAttribLocation(program, 0, "vertex");
+        glBindAttribLocation(program, 1, "in_color");
+        glBindAttribLocation(program, 2, "tex_coord");
+        glLinkProgram(program);
+        glValidateProgram(program);
+        GLint linked;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (linked == GL_FALSE) {
+            gl_log(program);
+            throw std::runtime_error("linking failed");
+        }
+
+        // Uniforms that a mode doesn't use are compiled out of its program; they are left at
+        // location -1, which GL ignores.
+        Uniforms& uniforms = gl.programs[mode].uniforms;
+        uniforms.screen.load(program);
+        uniforms.scale.load(program);
+        uniforms.sprite.load(program);
+        uniforms.static_image.load(program);
+        uniforms.static_fraction.load(program);
+        uniforms.unit.load(program);
+        uniforms.outline_color.load(program);
+        uniforms.outline_bounds.load(program);
+        uniforms.seed.load(program);
+        uniforms.tint.load(program);
+        uniforms.overlay_offset.load(program);
+        uniforms.palette.load(program);
+        gl.programs[mode].id = program;
+
+        gl.use(mode);
+        uniforms.sprite.set(0);
+        uniforms.static_image.set(1);
+        uniforms.palette.set(2);
+        uniforms.tint.set(-1);
+    }
+
+    // GL_MAJOR_VERSION is only understood by GL 3.0 and later; older contexts leave `major` as
+    // it was and raise an error, which is cleared here.
+    GLint major = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetError();
+    gl.fenced        = (major >= 3);
+    gl.vertex_arrays = (major >= 3);
+
+    glGenBuffers(1, &gl.stream);
+    glBindBuffer(GL_ARRAY_BUFFER, gl.stream);
+    glBufferData(
+            GL_ARRAY_BUFFER,
+            Context::kSegments * Context::kSegmentVertices * sizeof(Context::ColorVertex),
+            nullptr, GL_STREAM_DRAW);
+
+    // GL 2.0 has no vertex array objects, so there the two arrays only name the formats, and
+    // bind() points the attributes again whenever the format changes.
+    if (gl.vertex_arrays) {
+        glGenVertexArrays(1, &gl.color_array);
+        glBindVertexArray(gl.color_array);
+        point_attributes(false);
+        glGenVertexArrays(1, &gl.sprite_array);
+        glBindVertexArray(gl.sprite_array);
+        point_attributes(true);
+        gl.bound_array = gl.sprite_array;
+    } else {
+        gl.color_array  = 1;
+        gl.sprite_array = 2;
+        gl.bind(gl.sprite_array);
+    }
 
     GLuint static_texture;
     glGenTextures(1, &static_texture);
@@ -648,8 +1131,34 @@ OpenGlVideoDriver::MainLoop::Setup::Setup(OpenGlVideoDriver& driver) {
     glTexImage2D(
             GL_TEXTURE_2D, 0, GL_RG, size, size, 0, GL_RG, GL_UNSIGNED_BYTE, static_data.get());
 
-    driver._uniforms.sprite.set(0);
-    driver._uniforms.static_image.set(1);
+    // Row `h` of the palette holds the 256 shades of hue `h`, for tinting sprite overlays, and row
+    // `h + hues` holds the same shades, unconverted.
+    GLuint palette_texture;
+    glGenTextures(1, &palette_texture);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, palette_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    const int             hues = 16;
+    unique_ptr<uint8_t[]> palette_data(new uint8_t[hues * 2 * 256 * 4]);
+    p = palette_data.get();
+    for (int row = 0; row < (hues * 2); ++row) {
+        for (int shade = 0; shade < 256; ++shade) {
+            RgbColor c = RgbColor::tint(static_cast<Hue>(row % hues), shade);
+            if (row < hues) {
+                c = apple_rgb_to_srgb(c);
+            }
+            *(p++) = c.red;
+            *(p++) = c.green;
+            *(p++) = c.blue;
+            *(p++) = c.alpha;
+        }
+    }
+    glTexImage2D(
+            GL_TEXTURE_2D, 0, GL_RGBA, 256, hues * 2, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+            palette_data.get());
+
+    glActiveTexture(GL_TEXTURE0);
 }
 
 OpenGlVideoDriver::MainLoop::MainLoop(OpenGlVideoDriver& driver, Card* initial)
@@ -659,20 +1168,31 @@ void OpenGlVideoDriver::MainLoop::draw() {
     if (done()) {
         return;
     }
+    begin_frame();
+    _stack.top()->draw();
+    end_frame();
+}
 
+void OpenGlVideoDriver::MainLoop::begin_frame() {
     glClear(GL_COLOR_BUFFER_BIT);
     glViewport(0, 0, _driver.viewport_size().width, _driver.viewport_size().height);
 
-    auto screen = _driver.screen_size();
-    _driver._uniforms.screen.set({screen.width * 1.0f, screen.height * 1.0f});
-    _driver._uniforms.scale.set(_driver.scale());
+    // Passed on to each program by use().
+    auto screen        = _driver.screen_size();
+    _driver._gl.screen = {screen.width * 1.0f, screen.height * 1.0f};
+    _driver._gl.scale  = _driver.scale();
 
     int32_t seed = {_driver._static_seed.next(256)};
     seed <<= 8;
     seed += _driver._static_seed.next(256);
-    _driver._uniforms.seed.set(seed);
+    _driver._gl.seed = seed;
 
-    _stack.top()->draw();
+    _driver._gl.uploads = 0;
+}
+
+void OpenGlVideoDriver::MainLoop::end_frame() {
+    _driver._gl.flush();
+    ++_driver._gl.stats.frames;
 
     glFinish();
 }
@@ -37,11 +37,18 @@ struct OpenGlDynLinkFunctions {
     void (APIENTRYP glGenTextures)( GLsizei n, GLuint *textures );
     void (APIENTRYP glDeleteTextures)( GLsizei n, const GLuint *textures);
     VOID (APIENTRYP glBindTexture)( GLenum target, GLuint texture );
+    void (APIENTRYP glGetIntegerv)( GLenum pname, GLint *params );
 
     PFNGLACTIVETEXTUREPROC glActiveTexture;
     PFNGLBINDBUFFERPROC glBindBuffer;
     PFNGLGENBUFFERSPROC glGenBuffers;
     PFNGLBUFFERDATAPROC glBufferData;
+    PFNGLBUFFERSUBDATAPROC glBufferSubData;
+    PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
+    PFNGLUNMAPBUFFERPROC glUnmapBuffer;
+    PFNGLFENCESYNCPROC glFenceSync;
+    PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+    PFNGLDELETESYNCPROC glDeleteSync;
     PFNGLATTACHSHADERPROC glAttachShader;
 
     PFNGLBINDATTRIBLOCATIONPROC glBindAttribLocation;
@@ -91,6 +98,12 @@ void OpenGlDynLink::init_funcs(OpenGlVideoDriver& driver) {
     LINK_FUNC(glBindBuffer);
     LINK_FUNC(glGenBuffers);
     LINK_FUNC(glBufferData);
+    LINK_FUNC(glBufferSubData);
+    LINK_FUNC(glMapBufferRange);
+    LINK_FUNC(glUnmapBuffer);
+    LINK_FUNC(glFenceSync);
+    LINK_FUNC(glClientWaitSync);
+    LINK_FUNC(glDeleteSync);
     LINK_FUNC(glAttachShader);
     LINK_FUNC(glClearColor);
     LINK_FUNC(glClear);
@@ -105,6 +118,7 @@ void OpenGlDynLink::init_funcs(OpenGlVideoDriver& driver) {
     LINK_FUNC(glGenTextures);
     LINK_FUNC(glDeleteTextures);
     LINK_FUNC(glBindTexture);
+    LINK_FUNC(glGetIntegerv);
     LINK_FUNC(glBindAttribLocation);
     LINK_FUNC(glCompileShader);
     LINK_FUNC(glCreateProgram);
@@ -152,6 +166,30 @@ GLAPI void APIENTRY glBufferData (GLenum target, GLsizeiptr size, const void *da
     DLF.glBufferData(target, size, data, usage);
 }
 
+GLAPI void APIENTRY glBufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const void *data) {
+    DLF.glBufferSubData(target, offset, size, data);
+}
+
+GLAPI void *APIENTRY glMapBufferRange (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    return DLF.glMapBufferRange(target, offset, length, access);
+}
+
+GLAPI GLboolean APIENTRY glUnmapBuffer (GLenum target) {
+    return DLF.glUnmapBuffer(target);
+}
+
+GLAPI GLsync APIENTRY glFenceSync (GLenum condition, GLbitfield flags) {
+    return DLF.glFenceSync(condition, flags);
+}
+
+GLAPI GLenum APIENTRY glClientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout) {
+    return DLF.glClientWaitSync(sync, flags, timeout);
+}
+
+GLAPI void APIENTRY glDeleteSync (GLsync sync) {
+    DLF.glDeleteSync(sync);
+}
+
 GLAPI void APIENTRY glAttachShader (GLuint program, GLuint shader) {
     DLF.glAttachShader(program, shader);
 }
@@ -208,6 +246,10 @@ GLAPI void GLAPIENTRY glBindTexture( GLenum target, GLuint texture ) {
     DLF.glBindTexture(target, texture);
 }
 
+GLAPI void GLAPIENTRY glGetIntegerv( GLenum pname, GLint *params ) {
+    DLF.glGetIntegerv(pname, params);
+}
+
 GLAPI void APIENTRY glBindAttribLocation (GLuint program, GLuint index, const GLchar *name) {
     DLF.glBindAttribLocation(program, index, name);
 }
@@ -0,0 +1,624 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "video/software-driver.hpp"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cmath>
+#include <pn/output>
+#include <sfz/sfz.hpp>
+#include <thread>
+
+#include "drawing/color.hpp"
+#include "drawing/png-writer.hpp"
+#include "drawing/shapes.hpp"
+#include "game/sys.hpp"
+#include "ui/card.hpp"
+
+using sfz::dec;
+using std::max;
+using std::min;
+using std::pair;
+using std::unique_ptr;
+using std::vector;
+
+namespace antares {
+
+namespace {
+
+// Divides by 255, rounding to nearest, for `v` in [0, 255 * 255].
+inline uint8_t div255(int v) {
+    v += 128;
+    return (v + (v >> 8)) >> 8;
+}
+
+// Multiplies two levels, as GL multiplies normalized colors.
+inline uint8_t mul(int x, int y) { return div255(x * y); }
+
+// Blends `src` over `dst`, as glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA). The frame's own
+// alpha is left opaque, since snapshots are.
+inline void blend(RgbColor src, RgbColor* dst) {
+    const int a = src.alpha;
+    dst->red    = div255((src.red * a) + (dst->red * (255 - a)));
+    dst->green  = div255((src.green * a) + (dst->green * (255 - a)));
+    dst->blue   = div255((src.blue * a) + (dst->blue * (255 - a)));
+}
+
+// The spans below are plain loops over a row, without calls or branches in the common modes, so
+// that the compiler vectorizes them.
+
+void fill_span(RgbColor* row, int32_t count, RgbColor color) {
+    for (int32_t x = 0; x < count; ++x) {
+        blend(color, &row[x]);
+    }
+}
+
+void draw_span(RgbColor* row, int32_t count, const RgbColor* texels, const int32_t* columns) {
+    for (int32_t x = 0; x < count; ++x) {
+        blend(texels[columns[x]], &row[x]);
+    }
+}
+
+void tint_span(
+        RgbColor* row, int32_t count, const RgbColor* texels, const int32_t* columns,
+        RgbColor tint) {
+    for (int32_t x = 0; x < count; ++x) {
+        const RgbColor t = texels[columns[x]];
+        blend(rgba(mul(t.red, tint.red), mul(t.green, tint.green), mul(t.blue, tint.blue),
+                   mul(t.alpha, tint.alpha)),
+              &row[x]);
+    }
+}
+
+// The texel that the center of each pixel in [begin, end) maps to, when `dest` is mapped onto
+// `source` along one axis.
+void map_texels(
+        int32_t begin, int32_t end, int32_t dest_origin, int32_t dest_size, int32_t source_origin,
+        int32_t source_size, vector<int32_t>* texels) {
+    texels->resize(end - begin);
+    for (int32_t i = begin; i < end; ++i) {
+        const int64_t n      = (2 * int64_t{i - dest_origin} + 1) * source_size;
+        (*texels)[i - begin] = source_origin + (n / (2 * int64_t{dest_size}));
+    }
+}
+
+// Steps from `from` to `to`, including both ends, passing each pixel to `plot`.
+template <typename Plot>
+void step_line(Point from, Point to, Plot plot) {
+    const int32_t dx = abs(to.h - from.h), sx = (from.h < to.h) ? 1 : -1;
+    const int32_t dy = -abs(to.v - from.v), sy = (from.v < to.v) ? 1 : -1;
+    int32_t       error = dx + dy;
+    while (true) {
+        plot(from.h, from.v);
+        if ((from.h == to.h) && (from.v == to.v)) {
+            return;
+        }
+        const int32_t e2 = 2 * error;
+        if (e2 >= dy) {
+            error += dy;
+            from.h += sx;
+        }
+        if (e2 <= dx) {
+            error += dx;
+            from.v += sy;
+        }
+    }
+}
+
+// The alpha of `image` at (u, v), which is clamped to the centers of the pixels around `bounds`,
+// as if `bounds` were its own texture clamped to its edges.
+int outline_alpha(const PixMap& image, const Rect& bounds, float u, float v) {
+    u = min(max(u, bounds.left - 0.5f), bounds.right + 0.5f);
+    v = min(max(v, bounds.top - 0.5f), bounds.bottom + 0.5f);
+    return image.get(int32_t(std::floor(u)), int32_t(std::floor(v))).alpha;
+}
+
+// The square that draw_triangle(), draw_diamond() and draw_plus() draw into.
+Rect icon_rect(const Rect& rect) {
+    int32_t size = min(rect.width(), rect.height());
+    Rect    to(0, 0, size, size);
+    to.offset(rect.left, rect.top);
+    return to;
+}
+
+class DummyCard : public Card {
+  public:
+    void become_front() {
+        if (!_inited) {
+            sys_init();
+            _inited = true;
+        }
+    }
+
+  private:
+    bool _inited = false;
+};
+
+}  // namespace
+
+// Draws `region` of `image`, which has at least a 1-pixel clear border around it, for outlining.
+class SoftwareVideoDriver::TextureImpl : public Texture::Impl {
+  public:
+    TextureImpl(
+            pn::string_view name, SoftwareVideoDriver& driver,
+            std::shared_ptr<const ArrayPixMap> image, Rect region, int scale)
+            : _name(name.copy()),
+              _driver(driver),
+              _image(std::move(image)),
+              _region(region),
+              _size(region.size()),
+              _scale(scale) {}
+
+    virtual pn::string_view name() const { return _name; }
+
+    virtual void draw(const Rect& draw_rect) const {
+        push(Command::DRAW, draw_rect, texture_rect(), RgbColor::white());
+    }
+
+    virtual void draw_cropped(const Rect& dest, const Rect& source, const RgbColor& tint) const {
+        Rect texture_rect = source;
+        texture_rect.scale(_scale, _scale);
+        texture_rect.offset(_region.left, _region.top);
+        push(Command::TINT, dest, texture_rect, tint);
+    }
+
+    virtual void draw_shaded(const Rect& draw_rect, const RgbColor& tint) const {
+        push(Command::TINT, draw_rect, texture_rect(), tint);
+    }
+
+    virtual void draw_static(const Rect& draw_rect, const RgbColor& color, uint8_t frac) const {
+        Command c = command(Command::STATIC, draw_rect, texture_rect(), color);
+        c.frac    = frac;
+        _driver.push(std::move(c));
+    }
+
+    virtual void draw_outlined(
+            const Rect& draw_rect, const RgbColor& outline_color,
+            const RgbColor& fill_color) const {
+        if (draw_rect.empty()) {
+            return;
+        }
+        Command c = command(Command::OUTLINE, draw_rect, texture_rect(), fill_color);
+        c.outline = apple_rgb_to_srgb(outline_color);
+        c.bounds  = _region;
+        c.unit_x  = float(_size.width) / draw_rect.width();
+        c.unit_y  = float(_size.height) / draw_rect.height();
+        _driver.push(std::move(c));
+    }
+
+    virtual const Size& size() const { return _size; }
+
+  private:
+    // As OpenGlTextureImpl, which samples a `1 / scale` portion of a scaled texture.
+    Rect texture_rect() const {
+        const int32_t w = _size.width / _scale;
+        const int32_t h = _size.height / _scale;
+        return Rect(_region.left, _region.top, _region.left + w, _region.top + h);
+    }
+
+    Command command(
+            Command::Mode mode, const Rect& dest, const Rect& source,
+            const RgbColor& color) const {
+        Command c;
+        c.mode   = mode;
+        c.dest   = dest;
+        c.source = source;
+        c.color  = apple_rgb_to_srgb(color);
+        c.image  = _image;
+        return c;
+    }
+
+    void push(
+            Command::Mode mode, const Rect& dest, const Rect& source,
+            const RgbColor& color) const {
+        _driver.push(command(mode, dest, source, color));
+    }
+
+    const pn::string                         _name;
+    SoftwareVideoDriver&                     _driver;
+    const std::shared_ptr<const ArrayPixMap> _image;
+    const Rect                               _region;
+    Size                                     _size;
+    int                                      _scale;
+};
+
+class SoftwareVideoDriver::MainLoop : public EventScheduler::MainLoop {
+  public:
+    MainLoop(
+            SoftwareVideoDriver& driver, const sfz::optional<pn::string>& output_dir,
+            Card* initial)
+            : _driver(driver), _stack(initial) {
+        if (output_dir.has_value()) {
+            _output_dir.emplace(output_dir->copy());
+        }
+        if (output_dir.has_value() && !driver._video && !driver._expected) {
+            int threads = driver._png_threads;
+            if (threads <= 0) {
+                threads = max<int>(std::thread::hardware_concurrency(), 1);
+            }
+            _png.reset(new PngWriter(threads, threads * 2, driver._png_options));
+        }
+    }
+
+    bool takes_snapshots() {
+        return _output_dir.has_value() || _driver._video || _driver._expected;
+    }
+
+    void snapshot(wall_ticks ticks) {
+        snapshot_to(
+                _driver._capture_rect,
+                pn::format("screens/{0}.png", dec(ticks.time_since_epoch().count(), 6)));
+    }
+
+    void snapshot_to(Rect bounds, pn::string_view relpath) {
+        if (!takes_snapshots()) {
+            return;
+        }
+        bounds.scale(_driver._scale, _driver._scale);
+        if (_driver._expected) {
+            _driver._expected->check(relpath, _driver._frame.view(bounds));
+            return;
+        } else if (_driver._video) {
+            _driver._video->write(_driver._frame.view(bounds));
+            return;
+        }
+        ArrayPixMap pix(bounds.size());
+        pix.copy(_driver._frame.view(bounds));
+        _png->write(pn::format("{0}/{1}", *_output_dir, relpath), std::move(pix));
+    }
+
+    // Writes any snapshots still being encoded.
+    void finish() {
+        if (_png) {
+            _png->finish();
+        }
+    }
+
+    void draw() {
+        if (done()) {
+            return;
+        }
+        begin_frame();
+        _stack.top()->draw();
+        end_frame();
+    }
+
+    void begin_frame() {
+        int32_t seed = {_driver._static_seed.next(256)};
+        seed <<= 8;
+        seed += _driver._static_seed.next(256);
+        _driver._seed = seed;
+        _driver._commands.clear();
+    }
+
+    void end_frame() { _driver.rasterize(); }
+
+    bool  done() const { return _stack.empty(); }
+    Card* top() const { return _stack.top(); }
+
+  private:
+    SoftwareVideoDriver&      _driver;
+    CardStack                 _stack;
+    sfz::optional<pn::string> _output_dir;
+    unique_ptr<PngWriter>     _png;
+};
+
+SoftwareVideoDriver::SoftwareVideoDriver(
+        Size screen_size, int scale, const sfz::optional<pn::string>& output_dir)
+        : _screen_size(screen_size),
+          _scale(scale),
+          _capture_rect(screen_size.as_rect()),
+          _frame(screen_size.width * scale, screen_size.height * scale),
+          _static_seed{0} {
+    if (output_dir.has_value()) {
+        _output_dir.emplace(output_dir->copy());
+    }
+
+    // The same noise as OpenGlVideoDriver's static texture.
+    Random static_index = {0};
+    _static.resize(256 * 256);
+    for (uint8_t& value : _static) {
+        value = static_index.next(256);
+    }
+}
+
+SoftwareVideoDriver::~SoftwareVideoDriver() {
+    {
+        std::unique_lock<std::mutex> lock(_raster_mutex);
+        _raster_stopping = true;
+        _raster_changed.notify_all();
+    }
+    for (std::thread& thread : _raster_workers) {
+        thread.join();
+    }
+}
+
+bool SoftwareVideoDriver::start_editing(TextReceiver* text) { return false; }
+
+void SoftwareVideoDriver::stop_editing(TextReceiver* text) {}
+
+Texture SoftwareVideoDriver::texture(pn::string_view name, const PixMap& content, int scale) {
+    Size size = content.size();
+    size.width += 2;
+    size.height += 2;
+    ArrayPixMap copy(size);
+    copy.fill(RgbColor::clear());
+    copy.view(Rect(1, 1, size.width - 1, size.height - 1)).copy(content);
+    apple_rgb_to_srgb(&copy);
+    return unique_ptr<Texture::Impl>(new TextureImpl(
+            name, *this, std::make_shared<const ArrayPixMap>(std::move(copy)),
+            Rect(1, 1, size.width - 1, size.height - 1), scale));
+}
+
+void SoftwareVideoDriver::batch_rect(const Rect& rect, const RgbColor& color) {
+    fill(rect, color);
+}
+
+void SoftwareVideoDriver::dither_rect(const Rect& rect, const RgbColor& color) {
+    RgbColor half = color;
+    half.alpha    = (color.alpha + 1) / 2;
+    fill(rect, half);
+}
+
+void SoftwareVideoDriver::fill(const Rect& rect, const RgbColor& color) {
+    Command c;
+    c.mode  = Command::FILL;
+    c.dest  = rect;
+    c.color = apple_rgb_to_srgb(color);
+    push(std::move(c));
+}
+
+// As GL_POINTS of size 1, at the center of the pixel.
+void SoftwareVideoDriver::batch_point(const Point& at, const RgbColor& color) {
+    Command c;
+    c.mode = Command::FILL;
+    c.dest = Rect(at.h * _scale, at.v * _scale, at.h * _scale + 1, at.v * _scale + 1);
+    c.dest.offset(_scale / 2, _scale / 2);
+    c.color = apple_rgb_to_srgb(color);
+    _commands.push_back(std::move(c));
+}
+
+void SoftwareVideoDriver::batch_line(const Point& from, const Point& to, const RgbColor& color) {
+    Command c;
+    c.mode = Command::LINE;
+    c.dest = Rect(from.h * _scale, from.v * _scale, to.h * _scale, to.v * _scale);
+    c.color = apple_rgb_to_srgb(color);
+    _commands.push_back(std::move(c));
+}
+
+void SoftwareVideoDriver::draw_triangle(const Rect& rect, const RgbColor& color) {
+    draw_icon(IconInstance::TRIANGLE, rect, color);
+}
+
+void SoftwareVideoDriver::draw_diamond(const Rect& rect, const RgbColor& color) {
+    draw_icon(IconInstance::DIAMOND, rect, color);
+}
+
+void SoftwareVideoDriver::draw_plus(const Rect& rect, const RgbColor& color) {
+    draw_icon(IconInstance::PLUS, rect, color);
+}
+
+void SoftwareVideoDriver::draw_icon(
+        IconInstance::Shape shape, const Rect& rect, const RgbColor& color) {
+    const Rect                          to    = icon_rect(rect);
+    std::shared_ptr<const ArrayPixMap>& image = _icons[std::make_pair(shape, to.width())];
+    if (!image) {
+        ArrayPixMap pix(to.size());
+        pix.fill(RgbColor::clear());
+        switch (shape) {
+            case IconInstance::SQUARE: pix.fill(RgbColor::white()); break;
+            case IconInstance::TRIANGLE: draw_triangle_up(&pix, RgbColor::white()); break;
+            case IconInstance::DIAMOND: draw_compat_diamond(&pix, RgbColor::white()); break;
+            case IconInstance::PLUS: draw_compat_plus(&pix, RgbColor::white()); break;
+        }
+        image = std::make_shared<const ArrayPixMap>(std::move(pix));
+    }
+
+    Command c;
+    c.mode   = Command::TINT;
+    c.dest   = to;
+    c.source = to.size().as_rect();
+    c.color  = apple_rgb_to_srgb(color);
+    c.image  = image;
+    push(std::move(c));
+}
+
+// Scales `command` from screen coordinates to the frame's, and records it.
+void SoftwareVideoDriver::push(Command command) {
+    if (command.dest.empty()) {
+        return;
+    }
+    command.dest.scale(_scale, _scale);
+    _commands.push_back(std::move(command));
+}
+
+void SoftwareVideoDriver::rasterize() {
+    const int32_t height = _frame.size().height;
+    if (!_bands) {
+        _bands = max(min<int32_t>(_raster_threads, height), 1);
+        for (int i = 1; i < _bands; ++i) {
+            _raster_workers.emplace_back([this, i] { rasterize_band(i); });
+        }
+    }
+    if (_bands == 1) {
+        rasterize(0, height);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_raster_mutex);
+    ++_raster_frames;
+    _raster_pending = _bands - 1;
+    _raster_changed.notify_all();
+    lock.unlock();
+
+    rasterize(0, height / _bands);
+
+    lock.lock();
+    _raster_changed.wait(lock, [this] { return _raster_pending == 0; });
+}
+
+void SoftwareVideoDriver::rasterize_band(int band) {
+    const int32_t                height = _frame.size().height;
+    int64_t                      done   = 0;
+    std::unique_lock<std::mutex> lock(_raster_mutex);
+    while (true) {
+        _raster_changed.wait(
+                lock, [this, done] { return _raster_stopping || (_raster_frames > done); });
+        if (_raster_stopping) {
+            return;
+        }
+        done = _raster_frames;
+        lock.unlock();
+
+        rasterize(height * band / _bands, height * (band + 1) / _bands);
+
+        lock.lock();
+        --_raster_pending;
+        _raster_changed.notify_all();
+    }
+}
+
+// Applies every command to rows [top, bottom) of the frame.
+void SoftwareVideoDriver::rasterize(int32_t top, int32_t bottom) {
+    const Rect band(0, top, _frame.size().width, bottom);
+    _frame.view(band).fill(RgbColor::black());
+
+    vector<int32_t> columns, rows;
+    for (const Command& c : _commands) {
+        if (c.mode == Command::LINE) {
+            step_line(
+                    Point(c.dest.left, c.dest.top), Point(c.dest.right, c.dest.bottom),
+                    [this, &band, &c](int32_t x, int32_t y) {
+                        if (band.contains(Point(x, y))) {
+                            blend(c.color, &_frame.mutable_row(y)[x]);
+                        }
+                    });
+            continue;
+        }
+
+        Rect clip = c.dest;
+        clip.clip_to(band);
+        if (clip.empty()) {
+            continue;
+        }
+        const int32_t width = clip.width();
+
+        if (c.mode == Command::FILL) {
+            for (int32_t y = clip.top; y < clip.bottom; ++y) {
+                fill_span(_frame.mutable_row(y) + clip.left, width, c.color);
+            }
+            continue;
+        }
+
+        map_texels(
+                clip.left, clip.right, c.dest.left, c.dest.width(), c.source.left,
+                c.source.width(), &columns);
+        map_texels(
+                clip.top, clip.bottom, c.dest.top, c.dest.height(), c.source.top,
+                c.source.height(), &rows);
+        const PixMap& image = *c.image;
+        for (int32_t y = clip.top; y < clip.bottom; ++y) {
+            RgbColor*       row    = _frame.mutable_row(y) + clip.left;
+            const RgbColor* texels = image.row(rows[y - clip.top]);
+            switch (c.mode) {
+                case Command::DRAW: draw_span(row, width, texels, columns.data()); break;
+
+                case Command::TINT:
+                    tint_span(row, width, texels, columns.data(), c.color);
+                    break;
+
+                case Command::STATIC: {
+                    // As the shader samples the static texture at each pixel's center, offset by
+                    // the frame's seed, with GL_REPEAT and GL_NEAREST.
+                    const int32_t  scale = _scale;
+                    const uint8_t* noise = &_static[((y + (_seed * scale)) & 255) * 256];
+                    for (int32_t x = 0; x < width; ++x) {
+                        const int32_t  fx = clip.left + x;
+                        const int32_t  nx = ((256 * fx) + 128 + (_seed * scale * scale)) >> 8;
+                        const RgbColor t  = texels[columns[x]];
+                        if (noise[nx & 255] <= c.frac) {
+                            blend(rgba(c.color.red, c.color.green, c.color.blue,
+                                       mul(c.color.alpha, t.alpha)),
+                                  &row[x]);
+                        } else {
+                            blend(t, &row[x]);
+                        }
+                    }
+                    break;
+                }
+
+                case Command::OUTLINE: {
+                    // A pixel is outlined if it is more opaque than the average of its eight
+                    // neighbors, which are sampled `unit` texels away, within `bounds`.
+                    const float sx = float(c.source.width()) / c.dest.width();
+                    const float sy = float(c.source.height()) / c.dest.height();
+                    const float u0 = c.source.left + ((clip.left - c.dest.left + 0.5f) * sx);
+                    const float v  = c.source.top + ((y - c.dest.top + 0.5f) * sy);
+                    const float du = c.unit_x, dv = c.unit_y;
+                    for (int32_t x = 0; x < width; ++x) {
+                        const float u = u0 + (x * sx);
+                        const int   a = texels[columns[x]].alpha;
+
+                        int neighborhood = 0;
+                        for (float nu : {u - du, u, u + du}) {
+                            for (float nv : {v - dv, v, v + dv}) {
+                                neighborhood += outline_alpha(image, c.bounds, nu, nv);
+                            }
+                        }
+                        neighborhood -= outline_alpha(image, c.bounds, u, v);
+                        if ((a * 8) > neighborhood) {
+                            blend(c.outline, &row[x]);
+                        } else if (a > 0) {
+                            blend(c.color, &row[x]);
+                        }
+                    }
+                    break;
+                }
+
+                default: break;
+            }
+        }
+    }
+}
+
+unique_ptr<TeeVideoDriver::Output> SoftwareVideoDriver::tee_output() {
+    return unique_ptr<TeeVideoDriver::Output>(
+            new TeeVideoDriver::LoopOutput<MainLoop>(*this, _output_dir));
+}
+
+void SoftwareVideoDriver::loop(Card* initial, EventScheduler& scheduler) {
+    _scheduler = &scheduler;
+    MainLoop loop(*this, _output_dir, initial);
+    _scheduler->loop(loop);
+    loop.finish();
+    _scheduler = nullptr;
+}
+
+void SoftwareVideoDriver::capture(vector<pair<unique_ptr<Card>, pn::string>>& pix) {
+    MainLoop loop(*this, _output_dir, new DummyCard);
+    for (auto& p : pix) {
+        loop.top()->stack()->push(p.first.release());
+        loop.draw();
+        loop.snapshot_to(_capture_rect, p.second);
+        loop.top()->stack()->pop(loop.top());
+    }
+    loop.finish();
+}
+
+}  // namespace antares
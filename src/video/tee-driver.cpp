@@ -0,0 +1,307 @@
+// Copyright (C) 2026 The Antares Authors
+//
+// This file is part of Antares, a tactical space combat game.
+//
+// Antares is free software: you can redistribute it and/or modify it
+// under the terms of the Lesser GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Antares is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with Antares.  If not, see http://www.gnu.org/licenses/
+
+#include "video/tee-driver.hpp"
+
+#include "drawing/pix-map.hpp"
+#include "game/sys.hpp"
+
+using std::unique_ptr;
+using std::vector;
+
+namespace antares {
+
+namespace {
+
+// Makes a driver current for as long as it exists, then restores the previous one.
+class CurrentDriver {
+  public:
+    CurrentDriver(VideoDriver* driver) : _previous(sys.video) { sys.video = driver; }
+    CurrentDriver(const CurrentDriver&) = delete;
+    CurrentDriver& operator=(const CurrentDriver&) = delete;
+    ~CurrentDriver() { sys.video = _previous; }
+
+  private:
+    VideoDriver* const _previous;
+};
+
+}  // namespace
+
+template <typename Fn>
+void TeeVideoDriver::each(Fn fn) {
+    for (size_t i = 0; i < _drivers.size(); ++i) {
+        CurrentDriver current(_drivers[i].driver.get());
+        fn(*_drivers[i].driver, i);
+    }
+}
+
+// One texture from each driver, in the same order as the drivers.
+class TeeVideoDriver::TextureImpl : public Texture::Impl {
+  public:
+    TextureImpl(TeeVideoDriver& driver, pn::string_view name, Size size)
+            : _driver(driver), _name(name.copy()), _size(size) {}
+
+    vector<Texture>& textures() { return _textures; }
+    const Texture&   texture(size_t i) const { return _textures[i]; }
+
+    virtual pn::string_view name() const { return _name; }
+
+    virtual void draw(const Rect& draw_rect) const {
+        _driver.each([this, &draw_rect](VideoDriver&, size_t i) { impl(i).draw(draw_rect); });
+    }
+
+    virtual void draw_cropped(const Rect& dest, const Rect& source, const RgbColor& tint) const {
+        _driver.each([this, &dest, &source, &tint](VideoDriver&, size_t i) {
+            impl(i).draw_cropped(dest, source, tint);
+        });
+    }
+
+    virtual void draw_shaded(const Rect& draw_rect, const RgbColor& tint) const {
+        _driver.each([this, &draw_rect, &tint](VideoDriver&, size_t i) {
+            impl(i).draw_shaded(draw_rect, tint);
+        });
+    }
+
+    virtual void draw_static(const Rect& draw_rect, const RgbColor& color, uint8_t frac) const {
+        _driver.each([this, &draw_rect, &color, frac](VideoDriver&, size_t i) {
+            impl(i).draw_static(draw_rect, color, frac);
+        });
+    }
+
+    virtual void draw_outlined(
+            const Rect& draw_rect, const RgbColor& outline_color,
+            const RgbColor& fill_color) const {
+        _driver.each([this, &draw_rect, &outline_color, &fill_color](VideoDriver&, size_t i) {
+            impl(i).draw_outlined(draw_rect, outline_color, fill_color);
+        });
+    }
+
+    virtual const Size& size() const { return _size; }
+
+    virtual void begin_quads() const {
+        _driver.each([this](VideoDriver&, size_t i) { impl(i).begin_quads(); });
+    }
+
+    virtual void end_quads() const {
+        _driver.each([this](VideoDriver&, size_t i) { impl(i).end_quads(); });
+    }
+
+    virtual void draw_quad(const Rect& dest, const Rect& source, const RgbColor& tint) const {
+        _driver.each([this, &dest, &source, &tint](VideoDriver&, size_t i) {
+            impl(i).draw_quad(dest, source, tint);
+        });
+    }
+
+  private:
+    const Texture::Impl& impl(size_t i) const { return texture_impl<Texture::Impl>(_textures[i]); }
+
+    TeeVideoDriver& _driver;
+    pn::string      _name;
+    Size            _size;
+    vector<Texture> _textures;
+};
+
+class TeeVideoDriver::TextureAtlasImpl : public TextureAtlas::Impl {
+  public:
+    TextureAtlasImpl(TeeVideoDriver& driver) : _driver(driver) {}
+
+    vector<TextureAtlas>& atlases() { return _atlases; }
+
+    virtual Texture texture(pn::string_view name, const Rect& region, Hue hue) const {
+        unique_ptr<TextureImpl> texture(new TextureImpl(_driver, name, region.size()));
+        _driver.each([this, &texture, &name, &region, hue](VideoDriver&, size_t i) {
+            texture->textures().push_back(_atlases[i].texture(name, region, hue));
+        });
+        return unique_ptr<Texture::Impl>(std::move(texture));
+    }
+
+  private:
+    TeeVideoDriver&      _driver;
+    vector<TextureAtlas> _atlases;
+};
+
+class TeeVideoDriver::MainLoop : public EventScheduler::MainLoop {
+  public:
+    MainLoop(TeeVideoDriver& driver, Card* initial)
+            : _driver(driver), _outputs(outputs(driver)), _stack(initial) {}
+
+    bool takes_snapshots() {
+        for (const auto& output : _outputs) {
+            if (output->takes_snapshots()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void snapshot(wall_ticks ticks) {
+        for (const auto& output : _outputs) {
+            if (output->takes_snapshots()) {
+                output->snapshot(ticks);
+            }
+        }
+    }
+
+    void draw() {
+        if (done()) {
+            return;
+        }
+        _driver.each([this](VideoDriver&, size_t i) { _outputs[i]->begin_frame(); });
+        _stack.top()->draw();
+        _driver.each([this](VideoDriver&, size_t i) { _outputs[i]->end_frame(); });
+    }
+
+    // Writes any snapshots still being read back or encoded.
+    void finish() {
+        for (const auto& output : _outputs) {
+            output->finish();
+        }
+    }
+
+    bool  done() const { return _stack.empty(); }
+    Card* top() const { return _stack.top(); }
+
+  private:
+    // The outputs are made before the initial card becomes front, since it may load textures,
+    // which some drivers can only do once their loop has begun.
+    static vector<unique_ptr<Output>> outputs(TeeVideoDriver& driver) {
+        vector<unique_ptr<Output>> result;
+        driver.each([&driver, &result](VideoDriver&, size_t i) {
+            result.push_back(driver._drivers[i].output());
+        });
+        return result;
+    }
+
+    TeeVideoDriver&            _driver;
+    vector<unique_ptr<Output>> _outputs;
+    CardStack                  _stack;
+};
+
+void TeeVideoDriver::detach() { sys.video = nullptr; }
+
+void TeeVideoDriver::attach() { sys.video = this; }
+
+int TeeVideoDriver::scale() const { return _drivers.front().driver->scale(); }
+
+Size TeeVideoDriver::screen_size() const { return _drivers.front().driver->screen_size(); }
+
+bool TeeVideoDriver::start_editing(TextReceiver* text) { return false; }
+
+void TeeVideoDriver::stop_editing(TextReceiver* text) {}
+
+Texture TeeVideoDriver::texture(pn::string_view name, const PixMap& content, int scale) {
+    unique_ptr<TextureImpl> texture(new TextureImpl(*this, name, content.size()));
+    each([&texture, &name, &content, scale](VideoDriver& driver, size_t) {
+        texture->textures().push_back(driver.texture(name, content, scale));
+    });
+    return unique_ptr<Texture::Impl>(std::move(texture));
+}
+
+TextureAtlas TeeVideoDriver::atlas(Size size, AtlasLoader load) {
+    unique_ptr<TextureAtlasImpl> atlas(new TextureAtlasImpl(*this));
+    each([&atlas, size, &load](VideoDriver& driver, size_t) {
+        atlas->atlases().push_back(driver.atlas(size, load));
+    });
+    return unique_ptr<TextureAtlas::Impl>(std::move(atlas));
+}
+
+int64_t TeeVideoDriver::atlas_bytes() const {
+    int64_t bytes = 0;
+    for (const Driver& d : _drivers) {
+        bytes += d.driver->atlas_bytes();
+    }
+    return bytes;
+}
+
+void TeeVideoDriver::dither_rect(const Rect& rect, const RgbColor& color) {
+    each([&rect, &color](VideoDriver& driver, size_t) { driver.dither_rect(rect, color); });
+}
+
+void TeeVideoDriver::draw_triangle(const Rect& rect, const RgbColor& color) {
+    each([&rect, &color](VideoDriver& driver, size_t) { driver.draw_triangle(rect, color); });
+}
+
+void TeeVideoDriver::draw_diamond(const Rect& rect, const RgbColor& color) {
+    each([&rect, &color](VideoDriver& driver, size_t) { driver.draw_diamond(rect, color); });
+}
+
+void TeeVideoDriver::draw_plus(const Rect& rect, const RgbColor& color) {
+    each([&rect, &color](VideoDriver& driver, size_t) { driver.draw_plus(rect, color); });
+}
+
+// Each driver gets the sprites with its own textures in place of the tee's.
+void TeeVideoDriver::draw_sprites(const vector<SpriteInstance>& sprites) {
+    each([this, &sprites](VideoDriver& driver, size_t i) {
+        _sprites.assign(sprites.begin(), sprites.end());
+        for (SpriteInstance& sprite : _sprites) {
+            sprite.texture = &texture_impl<TextureImpl>(*sprite.texture).texture(i);
+        }
+        driver.draw_sprites(_sprites);
+    });
+}
+
+void TeeVideoDriver::draw_icons(const vector<IconInstance>& icons) {
+    each([&icons](VideoDriver& driver, size_t) { driver.draw_icons(icons); });
+}
+
+void TeeVideoDriver::begin_points() {
+    each([](VideoDriver& driver, size_t) { driver.begin_points(); });
+}
+
+void TeeVideoDriver::end_points() {
+    each([](VideoDriver& driver, size_t) { driver.end_points(); });
+}
+
+void TeeVideoDriver::batch_point(const Point& at, const RgbColor& color) {
+    each([&at, &color](VideoDriver& driver, size_t) { driver.batch_point(at, color); });
+}
+
+void TeeVideoDriver::begin_lines() {
+    each([](VideoDriver& driver, size_t) { driver.begin_lines(); });
+}
+
+void TeeVideoDriver::end_lines() {
+    each([](VideoDriver& driver, size_t) { driver.end_lines(); });
+}
+
+void TeeVideoDriver::batch_line(const Point& from, const Point& to, const RgbColor& color) {
+    each([&from, &to, &color](VideoDriver& driver, size_t) {
+        driver.batch_line(from, to, color);
+    });
+}
+
+void TeeVideoDriver::begin_rects() {
+    each([](VideoDriver& driver, size_t) { driver.begin_rects(); });
+}
+
+void TeeVideoDriver::end_rects() {
+    each([](VideoDriver& driver, size_t) { driver.end_rects(); });
+}
+
+void TeeVideoDriver::batch_rect(const Rect& rect, const RgbColor& color) {
+    each([&rect, &color](VideoDriver& driver, size_t) { driver.batch_rect(rect, color); });
+}
+
+void TeeVideoDriver::loop(Card* initial, EventScheduler& scheduler) {
+    _scheduler = &scheduler;
+    MainLoop loop(*this, initial);
+    _scheduler->loop(loop);
+    loop.finish();
+    _scheduler = nullptr;
+}
+
+}  // namespace antares
@@ -42,24 +42,10 @@ namespace path = sfz::path;
 
 namespace antares {
 
-namespace {
-
-pn::string hex(RgbColor color) {
-    char s[9];
-    if (color.alpha != 255) {
-        snprintf(s, 9, "%02x%02x%02x%02x", color.red, color.green, color.blue, color.alpha);
-    } else {
-        snprintf(s, 9, "%02x%02x%02x", color.red, color.green, color.blue);
-    }
-    return s;
-}
-
-}  // namespace
-
 class TextVideoDriver::TextureImpl : public Texture::Impl {
   public:
     TextureImpl(pn::string_view name, TextVideoDriver& driver, Size size)
-            : _name(name.copy()), _driver(driver), _size(size) {}
+            : _name(name.copy()), _id(driver.name_id(name)), _driver(driver), _size(size) {}
 
     virtual pn::string_view name() const { return _name; }
 
@@ -68,7 +54,8 @@ class TextVideoDriver::TextureImpl : public Texture::Impl {
             return;
         }
         _driver.log(
-                "draw", draw_rect.left, draw_rect.top, draw_rect.right, draw_rect.bottom, _name);
+                DrawOp::DRAW, draw_rect.left, draw_rect.top, draw_rect.right, draw_rect.bottom,
+                log_name());
     }
 
     virtual void draw_cropped(const Rect& dest, const Rect& source, const RgbColor& tint) const {
@@ -77,12 +64,12 @@ class TextVideoDriver::TextureImpl : public Texture::Impl {
         }
         if (source.size() == dest.size()) {
             _driver.log(
-                    "crop", dest.left, dest.top, dest.right, dest.bottom, source.left, source.top,
-                    hex(tint), _name);
+                    DrawOp::CROP, dest.left, dest.top, dest.right, dest.bottom, source.left,
+                    source.top, tint, log_name());
         } else {
             _driver.log(
-                    "crop", dest.left, dest.top, dest.right, dest.bottom, source.left, source.top,
-                    source.right, source.bottom, hex(tint), _name);
+                    DrawOp::CROP_SCALED, dest.left, dest.top, dest.right, dest.bottom, source.left,
+                    source.top, source.right, source.bottom, tint, log_name());
         }
     }
 
@@ -91,8 +78,8 @@ class TextVideoDriver::TextureImpl : public Texture::Impl {
             return;
         }
         _driver.log(
-                "tint", draw_rect.left, draw_rect.top, draw_rect.right, draw_rect.bottom,
-                hex(tint), _name);
+                DrawOp::TINT, draw_rect.left, draw_rect.top, draw_rect.right, draw_rect.bottom,
+                tint, log_name());
     }
 
     virtual void draw_static(const Rect& draw_rect, const RgbColor& color, uint8_t frac) const {
@@ -100,8 +87,8 @@ class TextVideoDriver::TextureImpl : public Texture::Impl {
             return;
         }
         _driver.log(
-                "static", draw_rect.left, draw_rect.top, draw_rect.right, draw_rect.bottom,
-                hex(color), frac, _name);
+                DrawOp::STATIC, draw_rect.left, draw_rect.top, draw_rect.right,
+                draw_rect.bottom, color, frac, log_name());
     }
 
     virtual void draw_outlined(
@@ -111,14 +98,17 @@ class TextVideoDriver::TextureImpl : public Texture::Impl {
             return;
         }
         _driver.log(
-                "outline", draw_rect.left, draw_rect.top, draw_rect.right, draw_rect.bottom,
-                hex(outline_color), hex(fill_color), _name.copy());
+                DrawOp::OUTLINE, draw_rect.left, draw_rect.top, draw_rect.right,
+                draw_rect.bottom, outline_color, fill_color, log_name());
     }
 
     virtual const Size& size() const { return _size; }
 
   private:
+    DrawLogName log_name() const { return DrawLogName{_id, _name}; }
+
     pn::string       _name;
+    uint32_t         _id;
     TextVideoDriver& _driver;
     Size             _size;
 };
@@ -132,24 +122,47 @@ class TextVideoDriver::MainLoop : public EventScheduler::MainLoop {
         }
     }
 
-    bool takes_snapshots() { return _output_dir.has_value(); }
+    bool takes_snapshots() { return _output_dir.has_value() || _driver._expected; }
 
+    // Goldens are text, so when comparing, a binary log is decoded and checked as a .txt file.
     void snapshot(wall_ticks ticks) {
-        snapshot_to(pn::format("screens/{0}.txt", dec(ticks.time_since_epoch().count(), 6)));
+        snapshot_to(pn::format(
+                "screens/{0}.{1}", dec(ticks.time_since_epoch().count(), 6),
+                (_driver._binary && !_driver._expected) ? "bin" : "txt"));
     }
 
     void snapshot_to(pn::string_view relpath) {
+        if (_driver._expected) {
+            const pn::string text = _driver._binary ? decode_draw_log(_driver._binary_log.data())
+                                                    : _driver._text.text().copy();
+            _driver._expected->check(
+                    relpath, pn::data_view{reinterpret_cast<const uint8_t*>(text.data()),
+                                           static_cast<int>(text.size())});
+            return;
+        }
         pn::string path = pn::format("{0}/{1}", *_output_dir, relpath);
         sfz::makedirs(path::dirname(path), 0755);
         pn::output out{path, pn::binary};
-        out.write(_driver._log);
+        if (_driver._binary) {
+            out.write(_driver._binary_log.data());
+        } else {
+            out.write(_driver._text.text());
+        }
     }
 
     void draw() {
-        _driver._log.clear();
-        _driver._last_args.clear();
+        begin_frame();
         _stack.top()->draw();
+        end_frame();
     }
+
+    void begin_frame() {
+        _driver._text.clear();
+        _driver._binary_log.clear();
+    }
+    void end_frame() {}
+    void finish() {}
+
     bool  done() const { return _stack.empty(); }
     Card* top() const { return _stack.top(); }
 
@@ -166,6 +179,18 @@ TextVideoDriver::TextVideoDriver(Size screen_size, const sfz::optional<pn::strin
     }
 }
 
+class TextVideoDriver::TextureAtlasImpl : public TextureAtlas::Impl {
+  public:
+    TextureAtlasImpl(TextVideoDriver& driver) : _driver(driver) {}
+
+    virtual Texture texture(pn::string_view name, const Rect& region, Hue hue) const {
+        return std::unique_ptr<Texture::Impl>(new TextureImpl(name, _driver, region.size()));
+    }
+
+  private:
+    TextVideoDriver& _driver;
+};
+
 int TextVideoDriver::scale() const { return 1; }
 
 bool TextVideoDriver::start_editing(TextReceiver* text) { return false; }
@@ -177,44 +202,59 @@ Texture TextVideoDriver::texture(pn::string_view name, const PixMap& content, in
     return std::unique_ptr<Texture::Impl>(new TextureImpl(name, *this, content.size()));
 }
 
+TextureAtlas TextVideoDriver::atlas(Size size, AtlasLoader load) {
+    return std::unique_ptr<TextureAtlas::Impl>(new TextureAtlasImpl(*this));
+}
+
+uint32_t TextVideoDriver::name_id(pn::string_view name) {
+    // Ids are handed out in order, so that BinaryDrawLog can index its definitions by them.
+    const uint32_t next = _name_ids.size();
+    return _name_ids.emplace(name.copy(), next).first->second;
+}
+
 void TextVideoDriver::batch_rect(const Rect& rect, const RgbColor& color) {
     if (!world().intersects(rect)) {
         return;
     }
-    log("rect", rect.left, rect.top, rect.right, rect.bottom, hex(color));
+    log(DrawOp::RECT, rect.left, rect.top, rect.right, rect.bottom, color);
 }
 
 void TextVideoDriver::dither_rect(const Rect& rect, const RgbColor& color) {
-    log("dither", rect.left, rect.top, rect.right, rect.bottom, hex(color));
+    log(DrawOp::DITHER, rect.left, rect.top, rect.right, rect.bottom, color);
 }
 
 void TextVideoDriver::batch_point(const Point& at, const RgbColor& color) {
-    log("point", at.h, at.v, hex(color));
+    log(DrawOp::POINT, at.h, at.v, color);
 }
 
 void TextVideoDriver::batch_line(const Point& from, const Point& to, const RgbColor& color) {
-    log("line", from.h, from.v, to.h, to.v, hex(color));
+    log(DrawOp::LINE, from.h, from.v, to.h, to.v, color);
 }
 
 void TextVideoDriver::draw_triangle(const Rect& rect, const RgbColor& color) {
     if (!world().intersects(rect)) {
         return;
     }
-    log("triangle", rect.left, rect.top, rect.right, rect.bottom, hex(color));
+    log(DrawOp::TRIANGLE, rect.left, rect.top, rect.right, rect.bottom, color);
 }
 
 void TextVideoDriver::draw_diamond(const Rect& rect, const RgbColor& color) {
     if (!world().intersects(rect)) {
         return;
     }
-    log("diamond", rect.left, rect.top, rect.right, rect.bottom, hex(color));
+    log(DrawOp::DIAMOND, rect.left, rect.top, rect.right, rect.bottom, color);
 }
 
 void TextVideoDriver::draw_plus(const Rect& rect, const RgbColor& color) {
     if (!world().intersects(rect)) {
         return;
     }
-    log("plus", rect.left, rect.top, rect.right, rect.bottom, hex(color));
+    log(DrawOp::PLUS, rect.left, rect.top, rect.right, rect.bottom, color);
+}
+
+unique_ptr<TeeVideoDriver::Output> TextVideoDriver::tee_output() {
+    return unique_ptr<TeeVideoDriver::Output>(
+            new TeeVideoDriver::LoopOutput<MainLoop>(*this, _output_dir));
 }
 
 void TextVideoDriver::loop(Card* initial, EventScheduler& scheduler) {
@@ -251,47 +291,19 @@ void TextVideoDriver::capture(vector<pair<unique_ptr<Card>, pn::string>>& pix) {
     }
 }
 
-void TextVideoDriver::add_arg(pn::string_view arg, std::vector<std::pair<size_t, size_t>>& args) {
-    size_t start = _log.size();
-    _log += arg;
-    args.push_back(make_pair(start, _log.size() - start));
-}
-
-void TextVideoDriver::dup_arg(size_t index, std::vector<std::pair<size_t, size_t>>& args) {
-    args.push_back(_last_args[index]);
-}
-
-pn::string_view TextVideoDriver::last_arg(size_t index) const {
-    return _log.substr(_last_args[index].first, _last_args[index].second);
-}
-
-static pn::string log_string(int i) { return pn::dump(i, pn::dump_short); }
-static pn::string log_string(pn::string_view s) { return s.copy(); }
-
 template <typename... Args>
-void TextVideoDriver::log(pn::string_view command, const Args&... args) {
-    vector<pair<size_t, size_t>> this_args;
-    pn::string                   str_args[]  = {log_string(args)...};
-    bool                         new_command = _last_args.empty() || (command != last_arg(0));
-
-    if (new_command) {
-        add_arg(command, this_args);
+void TextVideoDriver::log(DrawOp op, const Args&... args) {
+    if (_binary) {
+        _binary_log.begin(op);
+        int expand[] = {0, (_binary_log.arg(args), 0)...};
+        static_cast<void>(expand);
+        _binary_log.end();
     } else {
-        dup_arg(0, this_args);
+        _text.begin(op);
+        int expand[] = {0, (_text.arg(args), 0)...};
+        static_cast<void>(expand);
+        _text.end();
     }
-    for (size_t i = 0; i < sizeof...(args); ++i) {
-        _log += "\t";
-        pn::string_view s(str_args[i]);
-        if (new_command || (s != last_arg(i + 1))) {
-            add_arg(s, this_args);
-        } else {
-            dup_arg(i + 1, this_args);
-        }
-    }
-    _log += "\n";
-
-    using std::swap;
-    swap(this_args, _last_args);
 }
 
 }  // namespace antares